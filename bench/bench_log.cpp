@@ -0,0 +1,114 @@
+// Cost of a log call on the caller's thread: deferred binary logger vs
+// formatting in place like Serial.printf.
+//   pio run -e bench_log -t exec
+//
+// The printf baseline formats into a stack buffer (heap when the line is
+// longer, as Arduino's Print::printf does) and hands the bytes to a null
+// sink, so it excludes the USB-CDC write itself, which is where the real
+// Serial.printf can block. Drain cost is paid on the log task.
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "Log.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double nsSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+static volatile size_t sinkBytes = 0;
+
+static void nullSink(const char* buf, size_t len) {
+    sinkBytes = sinkBytes + len + (uint8_t)buf[0];
+}
+
+// Mirrors Print::printf: 64-byte stack buffer, heap for longer lines
+static void printfLike(const char* fmt, ...) {
+    char loc[64];
+    va_list ap;
+    va_start(ap, fmt);
+    int len = vsnprintf(loc, sizeof(loc), fmt, ap);
+    va_end(ap);
+    if (len < 0) return;
+    char* buf = loc;
+    if ((size_t)len >= sizeof(loc)) {
+        buf = (char*)malloc(len + 1);
+        va_start(ap, fmt);
+        vsnprintf(buf, len + 1, fmt, ap);
+        va_end(ap);
+    }
+    nullSink(buf, len);
+    if (buf != loc) free(buf);
+}
+
+struct Result {
+    double logNs;
+    double printfNs;
+    double drainNs;
+};
+
+// Logs `calls` records in ring-sized batches, draining between batches
+template <typename LogCall, typename PrintfCall>
+static Result run(int calls, LogCall logCall, PrintfCall printfCall) {
+    static Logger log;
+    Result r = {0, 0, 0};
+    int batches = calls / (int)LOG_RING_LEN;
+    for (int b = 0; b < batches; b++) {
+        auto t0 = Clock::now();
+        for (uint32_t i = 0; i < LOG_RING_LEN; i++) logCall(log, i);
+        r.logNs += nsSince(t0);
+        t0 = Clock::now();
+        log.drain(nullSink);
+        r.drainNs += nsSince(t0);
+    }
+    auto t0 = Clock::now();
+    for (int i = 0; i < batches * (int)LOG_RING_LEN; i++) printfCall((uint32_t)i);
+    r.printfNs = nsSince(t0);
+
+    int n = batches * (int)LOG_RING_LEN;
+    r.logNs /= n;
+    r.printfNs /= n;
+    r.drainNs /= n;
+    if (log.dropped()) printf("  (unexpected drops: %lu)\n", (unsigned long)log.dropped());
+    return r;
+}
+
+static void report(const char* name, const Result& r) {
+    printf("  %-12s log %6.1f ns   printf-like %7.1f ns (%4.1fx)   drain+format %6.1f ns\n", name, r.logNs,
+           r.printfNs, r.printfNs / r.logNs, r.drainNs);
+}
+
+int main() {
+    const int CALLS = 1 << 20;
+    std::string payload(300, 'j');   // typical WS json payload
+
+    printf("logger: ring %lu records, %d args, %d text bytes per record\n", (unsigned long)LOG_RING_LEN,
+           LOG_MAX_ARGS, LOG_TEXT_BYTES);
+
+    report("constant", run(
+        CALLS,
+        [](Logger& log, uint32_t) { log.write(LOG_LEVEL_INFO, "Recording start"); },
+        [](uint32_t) { printfLike("Recording start\n"); }));
+
+    report("button", run(
+        CALLS,
+        [](Logger& log, uint32_t i) {
+            log.write(LOG_LEVEL_INFO, "%s button sent (press-to-send %lu us, max %lu us)", "Approve", i, i * 2);
+        },
+        [](uint32_t i) {
+            printfLike("%s button sent (press-to-send %lu us, max %lu us)\n", "Approve", (unsigned long)i,
+                       (unsigned long)i * 2);
+        }));
+
+    report("ws json", run(
+        CALLS,
+        [&](Logger& log, uint32_t) { log.write(LOG_LEVEL_INFO, "WS json: %s", payload.c_str()); },
+        [&](uint32_t) { printfLike("WS json: %s\n", payload.c_str()); }));
+
+    printf("  (ws json: the logger keeps the first %d bytes of the payload)\n", LOG_TEXT_BYTES - 1);
+    return 0;
+}
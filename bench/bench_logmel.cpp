@@ -0,0 +1,79 @@
+// Per-frame cost of the log-mel front end on the host.
+//   pio run -e bench_logmel -t exec
+//
+// The device budget is one frame per MEL_HOP (10ms); on-device cost is
+// reported in the "Metrics:" serial block when built with UPLOAD_LOGMEL=1.
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "MelFrontend.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double usSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+}
+
+static double percentile(std::vector<double> v, double p) {
+    std::sort(v.begin(), v.end());
+    return v[(size_t)(p * (v.size() - 1))];
+}
+
+int main() {
+    static LogMelExtractor mel;
+    const int SECONDS = 60;
+    const int total = SAMPLE_RATE * SECONDS;
+
+    std::vector<int16_t> pcm(total);
+    uint32_t seed = 1;
+    for (int i = 0; i < total; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        double v = 0.3 * sin(2.0 * M_PI * 440.0 * i / SAMPLE_RATE) + 0.05 * (((int32_t)(seed >> 16) - 32768) / 32768.0);
+        pcm[i] = (int16_t)lrint(v * 32767.0);
+    }
+
+    // 1) computeFrame alone (window + FFT + filterbank + log)
+    static float frame[MEL_N_FFT];
+    static float out[MEL_BINS];
+    std::vector<double> frameUs;
+    for (int t = 0; t + MEL_N_FFT <= total && frameUs.size() < 5000; t += MEL_HOP) {
+        for (int i = 0; i < MEL_N_FFT; i++) frame[i] = pcm[t + i] / 32768.0f;
+        auto t0 = Clock::now();
+        mel.computeFrame(frame, out);
+        frameUs.push_back(usSince(t0));
+    }
+
+    // 2) Streaming: CHUNK_SAMPLES pushes + quantize, as AudioManager does
+    static float melOut[MEL_FRAMES_PER_CHUNK_MAX * MEL_BINS];
+    static int16_t q[MEL_FRAMES_PER_CHUNK_MAX * MEL_BINS];
+    std::vector<double> chunkUs;
+    size_t frames = 0;
+    mel.reset();
+    auto all0 = Clock::now();
+    for (int pos = 0; pos + CHUNK_SAMPLES <= total; pos += CHUNK_SAMPLES) {
+        auto t0 = Clock::now();
+        size_t f = mel.push(&pcm[pos], CHUNK_SAMPLES, melOut);
+        LogMelExtractor::quantize(melOut, q, f * MEL_BINS);
+        chunkUs.push_back(usSince(t0));
+        frames += f;
+    }
+    frames += mel.flush(melOut);
+    double allUs = usSince(all0);
+
+    double avg = 0;
+    for (double v : frameUs) avg += v;
+    avg /= frameUs.size();
+    double budgetUs = 1e6 * MEL_HOP / SAMPLE_RATE;
+
+    printf("log-mel front end (%d bins, n_fft %d, hop %d)\n", MEL_BINS, MEL_N_FFT, MEL_HOP);
+    printf("  computeFrame: n=%zu avg %.2f us p50 %.2f us p99 %.2f us max %.2f us\n", frameUs.size(), avg,
+           percentile(frameUs, 0.5), percentile(frameUs, 0.99), percentile(frameUs, 1.0));
+    printf("  per-frame budget %.0f us -> %.0fx headroom on this host\n", budgetUs, budgetUs / avg);
+    printf("  streaming %ds: %zu frames in %.1f ms (%.0fx realtime), chunk p99 %.2f us\n", SECONDS, frames,
+           allUs / 1000.0, SECONDS * 1e6 / allUs, percentile(chunkUs, 0.99));
+    printf("  upload: %d B/s log-mel vs %d B/s PCM\n",
+           MEL_BINS * 2 * SAMPLE_RATE / MEL_HOP, SAMPLE_RATE * BIT_DEPTH / 8 * CHANNELS);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Throughput of the upload pipeline on the host: audio source -> chunk ->
+// frame (PCM or log-mel) -> NetLink -> send, into a null sink.
+//   pio run -e bench_pipeline -t exec
+//   .pio/build/bench_pipeline/program [hours] [file.wav|file.pcm]
+//
+// Framing is the firmware's own UploadFramer; the network task's drain
+// loop is replayed into the sink. Audio is split into MAX_RECORD_MS
+// utterances with start / end commands. Everything runs on one thread, so
+// per-stage times add up to the wall time; "pipeline" excludes the
+// test-signal generator, which the device does not run. Default input is
+// SYNTH_SPEECH for 2 hours.
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include "AudioSource.h"
+#include "UploadFramer.h"
+
+using Clock = std::chrono::steady_clock;
+
+static const Clock::time_point epoch = Clock::now();
+
+static uint32_t nowUs() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - epoch).count();
+}
+
+struct StageStat {
+    const char* name;
+    double totalNs = 0;
+    double maxNs = 0;
+    uint64_t count = 0;
+
+    void add(Clock::time_point t0, Clock::time_point t1) {
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        totalNs += ns;
+        if (ns > maxNs) maxNs = ns;
+        count++;
+    }
+};
+
+// The network task's sink with the socket replaced by a checksum
+struct NullSink {
+    uint64_t bytes = 0;
+    uint32_t frames = 0;
+    uint32_t commands = 0;
+    uint32_t checksum = 0;
+
+    void onCommand(const NetCommand& cmd) {
+        commands++;
+        checksum += (uint8_t)cmd.reqId[0];
+    }
+    void onAudio(const AudioFrame& f) {
+        frames++;
+        bytes += f.len;
+        checksum = checksum * 31 + f.data[0] + f.data[f.len - 1];
+    }
+};
+
+static void run(const char* label, bool logMel, AudioSource& src, uint64_t samples) {
+    NetLink link;
+    static LogMelExtractor mel;
+    UploadFramer up(link, logMel ? &mel : nullptr, nowUs);
+
+    StageStat source{"source"}, upload{"upload"}, send{"send"};
+    NullSink sink;
+    const uint64_t chunksPerUtterance = (uint64_t)MAX_RECORD_MS * SAMPLE_RATE / 1000 / CHUNK_SAMPLES;
+    uint64_t chunks = samples / CHUNK_SAMPLES;
+    char reqId[REQ_ID_MAX_LEN];
+
+    if (!src.begin()) {
+        fprintf(stderr, "%s: cannot start source %s\n", label, src.name());
+        return;
+    }
+
+    // Drains what the framer posted right away, as the network task would
+    auto drain = [&](Clock::time_point t0) {
+        auto t1 = Clock::now();
+        link.drain(sink, nowUs, NET_AUDIO_QUEUE_LEN);
+        upload.add(t0, t1);
+        send.add(t1, Clock::now());
+    };
+
+    auto wall0 = Clock::now();
+    for (uint64_t c = 0; c < chunks; c++) {
+        if (c % chunksPerUtterance == 0) {
+            snprintf(reqId, sizeof(reqId), "req-bench-%llu", (unsigned long long)(c / chunksPerUtterance));
+            up.start(reqId);
+        }
+
+        auto t0 = Clock::now();
+        const int16_t* pcm = src.acquire(0);
+        auto t1 = Clock::now();
+        source.add(t0, t1);
+        if (!pcm) {
+            // Source ran dry mid-utterance: close it as the firmware would
+            auto f0 = Clock::now();
+            up.finish();
+            drain(f0);
+            break;
+        }
+
+        up.chunk(pcm);
+        src.release();
+        drain(t1);
+
+        if ((c + 1) % chunksPerUtterance == 0 || c + 1 == chunks) {
+            auto f0 = Clock::now();
+            up.finish();
+            drain(f0);
+        }
+    }
+    double wallS = std::chrono::duration<double>(Clock::now() - wall0).count();
+    src.end();
+
+    double audioS = (double)source.count * CHUNK_SAMPLES / SAMPLE_RATE;
+    double pipeNs = upload.totalNs + send.totalNs;
+    printf("%s: %.2f h of %s audio in %.2f s\n", label, audioS / 3600.0, src.name(), wallS);
+    printf("  realtime x%.0f end to end, x%.0f pipeline only (budget %.0f us per %d-sample chunk)\n",
+           audioS / wallS, audioS * 1e9 / pipeNs, 1e6 * CHUNK_SAMPLES / SAMPLE_RATE, CHUNK_SAMPLES);
+    const StageStat* stages[] = {&source, &upload, &send};
+    for (const StageStat* s : stages) {
+        printf("  %-6s n=%-8llu avg %8.3f us max %8.1f us  %5.1f%%\n", s->name, (unsigned long long)s->count,
+               s->count ? s->totalNs / s->count / 1000.0 : 0.0, s->maxNs / 1000.0,
+               100.0 * s->totalNs / (wallS * 1e9));
+    }
+    if (logMel) {
+        const LatencyStat& f = up.featureFrameCost();
+        printf("  log-mel per frame avg %lu us max %lu us\n", (unsigned long)f.avgUs(), (unsigned long)f.maxUs);
+    }
+    printf("  sent %u frames, %.1f MB (%.0f B/s of audio), %u commands, %u dropped, checksum %08x\n",
+           sink.frames, sink.bytes / 1e6, sink.bytes / audioS, sink.commands, up.dropped(), sink.checksum);
+    const LatencyStat& lat = link.audioLatency();
+    printf("  post -> send latency avg %lu us max %lu us\n", (unsigned long)lat.avgUs(), (unsigned long)lat.maxUs);
+}
+
+int main(int argc, char** argv) {
+    double hours = argc > 1 ? atof(argv[1]) : 2.0;
+    const char* path = argc > 2 ? argv[2] : nullptr;
+    uint64_t samples = (uint64_t)(hours * 3600.0 * SAMPLE_RATE);
+
+    SynthSource synth;
+    FileSource file(path, true);
+    AudioSource& src = path ? (AudioSource&)file : (AudioSource&)synth;
+
+    run("pcm", false, src, samples);
+    run("logmel", true, src, samples);
+    return 0;
+}
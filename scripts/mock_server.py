@@ -27,6 +27,7 @@ async def input_loop():
 
 async def handler(websocket):
     print(f"Client connected: {websocket.remote_address}")
+    frame_bytes = None  # log-mel upload: bytes per feature frame
     try:
         async for message in websocket:
             if isinstance(message, str):
@@ -36,6 +37,10 @@ async def handler(websocket):
                     print(f"Received JSON: {data.get('type')}")
                     if data.get('type') == 'start':
                         print(f"  Start params: {data}")
+                        if str(data.get('format', '')).startswith('logmel'):
+                            frame_bytes = int(data.get('nMels', 80)) * 2
+                        else:
+                            frame_bytes = None
                     elif data.get('type') == 'end':
                         print("  End received. Sending Ack & Result.")
                         await websocket.send(json.dumps({"type": "ack", "reqId": data.get("reqId")}))
@@ -44,7 +49,10 @@ async def handler(websocket):
                     print(f"Received text (invalid JSON): {message}")
             elif isinstance(message, bytes):
                 # Binary audio
-                print(f"Received Audio: {len(message)} bytes")
+                if frame_bytes:
+                    print(f"Received Features: {len(message) // frame_bytes} frames ({len(message)} bytes)")
+                else:
+                    print(f"Received Audio: {len(message)} bytes")
     except websockets.ConnectionClosed:
         print("Client disconnected")
 
@@ -71,11 +79,11 @@ async def broadcaster(server):
         else:
             print("No clients connected to receive broadcast.")
 
-async def main():
-    print("Starting Mock ASR Server on 0.0.0.0:8765")
+async def main(port):
+    print(f"Starting Mock ASR Server on 0.0.0.0:{port}")
     print("Commands: p (Permission), f (Failure), s (Stop), q (Quit)")
     
-    async with websockets.serve(handler, "0.0.0.0", 8765) as server:
+    async with websockets.serve(handler, "0.0.0.0", port) as server:
         # Start input loop and broadcaster
         asyncio.create_task(input_loop())
         asyncio.create_task(broadcaster(server))
@@ -83,6 +91,8 @@ async def main():
 
 if __name__ == "__main__":
     try:
-        asyncio.run(main())
+        # --port N: e.g. 8766 behind scripts/netem_proxy.py listening on 8765
+        port = int(sys.argv[sys.argv.index("--port") + 1]) if "--port" in sys.argv else 8765
+        asyncio.run(main(port))
     except KeyboardInterrupt:
         pass
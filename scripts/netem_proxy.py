@@ -0,0 +1,297 @@
+"""Deterministic network-impairment TCP proxy.
+
+Sits between the device (or the regression client) and the mock server and
+injects seeded latency, jitter, bandwidth caps, stalls and connection resets.
+Every random decision is drawn from (seed, connection index, direction,
+segment index), so a profile + seed replays the same impairment for the same
+byte stream regardless of how the OS splits reads.
+
+    # device -> proxy :8765 -> mock server :8766
+    python scripts/mock_server.py --port 8766
+    python scripts/netem_proxy.py --listen 0.0.0.0:8765 --target 127.0.0.1:8766 --profile wifi_jitter --seed 7
+"""
+import argparse
+import asyncio
+import json
+import os
+import random
+import socket
+import struct
+import sys
+
+SEGMENT = 1460   # decision grid, bytes (one Ethernet MSS)
+WINDOW = 65535   # bytes in flight per direction before the proxy stops reading (TCP window)
+
+PROFILES_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "netem_profiles.json")
+DIRECTIONS = ("up", "down")
+PARAM_KEYS = ("latency_ms", "jitter_ms", "bandwidth_kbps", "stall_prob", "stall_ms")
+
+
+def load_profile(name_or_path):
+    """Profile by name from netem_profiles.json, or a JSON file path."""
+    if os.path.exists(name_or_path):
+        with open(name_or_path) as f:
+            return json.load(f)
+    with open(PROFILES_PATH) as f:
+        profiles = json.load(f)
+    if name_or_path not in profiles or name_or_path.startswith("_"):
+        names = ", ".join(k for k in profiles if not k.startswith("_"))
+        raise SystemExit(f"unknown profile {name_or_path!r} (have: {names})")
+    return profiles[name_or_path]
+
+
+class Profile:
+    """Resolves the parameters in force for a direction at a given time."""
+
+    def __init__(self, spec):
+        self.spec = spec or {}
+        self.timeline = sorted(self.spec.get("timeline", []), key=lambda e: e["at_s"])
+        self.resets = [tuple(r) for r in self.spec.get("resets", [])]
+
+    def params(self, direction, t):
+        p = {k: self.spec[k] for k in PARAM_KEYS if k in self.spec}
+        p.update(self.spec.get(direction, {}))
+        for ev in self.timeline:
+            if ev["at_s"] > t:
+                break
+            for k, v in ev["set"].items():
+                if k in DIRECTIONS:
+                    p.update(v)
+                else:
+                    p[k] = v
+        return {k: v for k, v in p.items() if v is not None}
+
+
+class DirectionStats:
+    def __init__(self):
+        self.bytes = 0
+        self.segments = 0
+        self.stalls = 0
+        self.max_delay_ms = 0.0
+
+    def as_dict(self):
+        return dict(bytes=self.bytes, segments=self.segments, stalls=self.stalls,
+                    max_delay_ms=round(self.max_delay_ms, 2))
+
+
+class Pipe:
+    """One direction of one connection: timestamps and delays every byte."""
+
+    def __init__(self, proxy, conn_index, direction, writer):
+        self.proxy = proxy
+        self.conn_index = conn_index
+        self.direction = direction
+        self.writer = writer
+        self.queue = asyncio.Queue()
+        self.offset = 0           # absolute byte offset in this direction
+        self.release_at = 0.0     # in-order delivery: never before the previous chunk
+        self.link_free_at = 0.0   # bandwidth serialisation
+        self.stall_until = 0.0
+        self.pending = 0          # queued, not yet delivered
+        self.stats = DirectionStats()
+        self._cell = None
+
+    def _draws(self, k):
+        """Random draws for segment cell k (cached, order independent)."""
+        if self._cell and self._cell[0] == k:
+            return self._cell[1]
+        rng = random.Random(f"{self.proxy.seed}:{self.conn_index}:{self.direction}:{k}")
+        d = (rng.random(), rng.random(), rng.random())
+        self._cell = (k, d)
+        return d
+
+    def schedule(self, data, now):
+        """Splits data on the segment grid and queues (deliver_at, bytes)."""
+        t = now - self.proxy.start
+        p = self.proxy.profile.params(self.direction, t)
+        lat = p.get("latency_ms", 0) / 1000.0
+        jit = p.get("jitter_ms", 0) / 1000.0
+        bps = p.get("bandwidth_kbps", 0) * 1000.0
+        stall_prob = p.get("stall_prob", 0)
+        stall_lo, stall_hi = p.get("stall_ms", [0, 0])
+
+        pos = 0
+        while pos < len(data):
+            k = self.offset // SEGMENT
+            n = min(len(data) - pos, SEGMENT - self.offset % SEGMENT)
+            chunk = data[pos:pos + n]
+            r_jit, r_stall, r_stall_len = self._draws(k)
+            first_in_cell = self.offset % SEGMENT == 0
+
+            if first_in_cell:
+                self.stats.segments += 1
+                if stall_prob and r_stall < stall_prob:
+                    self.stats.stalls += 1
+                    self.stall_until = max(self.stall_until,
+                                           now + (stall_lo + (stall_hi - stall_lo) * r_stall_len) / 1000.0)
+
+            delay = max(0.0, lat + (2 * r_jit - 1) * jit)
+            ready = max(now + delay, self.release_at, self.stall_until)
+            if bps:
+                start = max(ready, self.link_free_at)
+                self.link_free_at = start + len(chunk) * 8 / bps
+                ready = self.link_free_at
+            self.release_at = ready
+            self.stats.max_delay_ms = max(self.stats.max_delay_ms, (ready - now) * 1000.0)
+            self.stats.bytes += n
+            self.pending += n
+            self.queue.put_nowait((ready, chunk))
+            self.offset += n
+            pos += n
+
+    async def deliver(self):
+        loop = asyncio.get_running_loop()
+        while True:
+            at, chunk = await self.queue.get()
+            if chunk is None:
+                break
+            wait = at - loop.time()
+            if wait > 0:
+                await asyncio.sleep(wait)
+            self.writer.write(chunk)
+            await self.writer.drain()
+            self.pending -= len(chunk)
+
+
+def _abort_with_rst(writer):
+    sock = writer.get_extra_info("socket")
+    if sock is not None:
+        try:
+            sock.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+        except OSError:
+            pass
+    writer.transport.abort()
+
+
+class ImpairedProxy:
+    def __init__(self, target_host, target_port, profile, seed=1, log=None):
+        self.target = (target_host, target_port)
+        self.profile = Profile(profile)
+        self.seed = seed
+        self.log = log or (lambda msg: None)
+        self.connections = []   # per connection: dict of stats
+        self.start = 0.0
+        self.server = None
+        self._active = {}        # handler task -> writers, for close()
+
+    async def start_server(self, host, port):
+        self.start = asyncio.get_running_loop().time()
+        self.server = await asyncio.start_server(self._on_client, host, port)
+        return self.server.sockets[0].getsockname()[1]
+
+    async def close(self):
+        if self.server:
+            self.server.close()
+        for writers in list(self._active.values()):
+            for w in writers:
+                w.transport.abort()
+        if self._active:
+            await asyncio.wait(list(self._active), timeout=1.0)
+        if self.server:
+            await self.server.wait_closed()
+
+    async def _on_client(self, c_reader, c_writer):
+        index = len(self.connections)
+        info = {"index": index, "reset": False}
+        self.connections.append(info)
+        me = asyncio.current_task()
+        self._active[me] = [c_writer]
+        try:
+            await self._relay(index, info, c_reader, c_writer)
+        finally:
+            del self._active[me]
+
+    async def _relay(self, index, info, c_reader, c_writer):
+        loop = asyncio.get_running_loop()
+        try:
+            s_reader, s_writer = await asyncio.open_connection(*self.target)
+        except OSError as e:
+            self.log(f"[proxy] #{index} upstream connect failed: {e}")
+            _abort_with_rst(c_writer)
+            return
+        self._active[asyncio.current_task()].append(s_writer)
+        self.log(f"[proxy] #{index} connected")
+
+        up = Pipe(self, index, "up", s_writer)
+        down = Pipe(self, index, "down", c_writer)
+        info["up"], info["down"] = up.stats, down.stats
+
+        async def pump(reader, pipe):
+            try:
+                while True:
+                    data = await reader.read(65536)
+                    if not data:
+                        break
+                    pipe.schedule(data, loop.time())
+                    # Back-pressure: a slow link fills the window, then the sender blocks
+                    while pipe.pending > WINDOW:
+                        await asyncio.sleep(0.005)
+            except (ConnectionError, OSError):
+                pass
+            # Half-close travels in order behind the data
+            pipe.queue.put_nowait((pipe.release_at, None))
+
+        tasks = [
+            asyncio.create_task(pump(c_reader, up)),
+            asyncio.create_task(pump(s_reader, down)),
+            asyncio.create_task(up.deliver()),
+            asyncio.create_task(down.deliver()),
+        ]
+        resets = [at for conn, at in self.profile.resets if conn == index]
+        if resets:
+            async def reset_later(at):
+                await asyncio.sleep(at)
+                info["reset"] = True
+                self.log(f"[proxy] #{index} reset at {at:.2f}s")
+                _abort_with_rst(c_writer)
+                _abort_with_rst(s_writer)
+                for t in tasks[:4]:
+                    t.cancel()
+            tasks.append(asyncio.create_task(reset_later(min(resets))))
+
+        done, pending = await asyncio.wait(tasks[2:4], return_when=asyncio.FIRST_COMPLETED)
+        for t in tasks:
+            t.cancel()
+        for w in (c_writer, s_writer):
+            try:
+                w.close()
+            except Exception:
+                pass
+        self.log(f"[proxy] #{index} closed up={up.stats.as_dict()} down={down.stats.as_dict()}")
+
+    def stats(self):
+        out = []
+        for c in self.connections:
+            out.append({
+                "index": c["index"],
+                "reset": c["reset"],
+                "up": c["up"].as_dict() if "up" in c else None,
+                "down": c["down"].as_dict() if "down" in c else None,
+            })
+        return out
+
+
+def _hostport(s):
+    host, _, port = s.rpartition(":")
+    return host or "0.0.0.0", int(port)
+
+
+async def _main(args):
+    profile = load_profile(args.profile)
+    proxy = ImpairedProxy(*_hostport(args.target), profile, seed=args.seed, log=print)
+    host, port = _hostport(args.listen)
+    await proxy.start_server(host, port)
+    print(f"netem proxy {host}:{port} -> {args.target} profile={args.profile} seed={args.seed}")
+    await asyncio.Future()
+
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--listen", default="0.0.0.0:8765")
+    ap.add_argument("--target", default="127.0.0.1:8766")
+    ap.add_argument("--profile", default="wifi_jitter", help="name in netem_profiles.json or a JSON file")
+    ap.add_argument("--seed", type=int, default=1)
+    try:
+        asyncio.run(_main(ap.parse_args()))
+    except KeyboardInterrupt:
+        sys.exit(0)
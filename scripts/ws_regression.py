@@ -0,0 +1,453 @@
+"""Protocol / latency regression suite over an impaired network.
+
+Runs record / hook / command scenarios between a firmware stand-in (same
+messages, 20ms frame cadence, 16-frame send queue, small TCP send buffer,
+2s reconnect interval like WebSocketsClient) and a mock ASR server, with
+netem_proxy.py in between. Asserts bounded end-to-end latency and no audio
+loss, and writes machine-readable results for comparison between commits.
+
+Stdlib only (uses wslite.py instead of the `websockets` package).
+
+    python scripts/ws_regression.py --out results.json
+    python scripts/ws_regression.py --baseline old.json --out new.json
+    python scripts/ws_regression.py --only clean,stalls --seed 3
+"""
+import argparse
+import asyncio
+import json
+import os
+import socket
+import struct
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import wslite                                      # noqa: E402
+from netem_proxy import ImpairedProxy, load_profile  # noqa: E402
+
+# Mirrors src/Config.h
+CHUNK_MS = 20
+CHUNK_BYTES = 640            # pcm_s16le, 320 samples
+LOGMEL_CHUNK_BYTES = 2 * 80 * 2   # two 10ms frames of 80 int16
+NET_AUDIO_QUEUE_LEN = 16
+RECONNECT_INTERVAL_S = 2.0
+DEVICE_SNDBUF = 5744         # lwIP default TCP_SND_BUF (4 * MSS)
+
+FRAME_HEADER = struct.Struct("<IQ")   # seq, send time (monotonic ns)
+
+# limits: audio_p99_ms / hook_p95_ms / cmd_p95_ms / result_max_ms bound the
+# latencies; audio_loss is the max frames lost after a successful send or to
+# send-queue overflow (None = unchecked, e.g. across a reset).
+SCENARIOS = [
+    dict(name="clean", profile="clean", utterances=[2.0, 2.0],
+         limits=dict(audio_p99_ms=50, hook_p95_ms=50, cmd_p95_ms=50, result_max_ms=200, audio_loss=0)),
+    dict(name="wifi_jitter", profile="wifi_jitter", utterances=[2.0, 2.0],
+         limits=dict(audio_p99_ms=150, hook_p95_ms=150, cmd_p95_ms=150, result_max_ms=400, audio_loss=0)),
+    dict(name="congested", profile="congested", utterances=[3.0],
+         limits=dict(audio_p99_ms=400, hook_p95_ms=300, cmd_p95_ms=400, result_max_ms=800, audio_loss=0)),
+    dict(name="stalls", profile="stalls", utterances=[3.0, 2.0],
+         limits=dict(audio_p99_ms=600, hook_p95_ms=100, cmd_p95_ms=600, result_max_ms=1000, audio_loss=0)),
+    dict(name="fade", profile="fade", utterances=[4.0],
+         limits=dict(audio_p99_ms=900, hook_p95_ms=400, cmd_p95_ms=900, result_max_ms=1200, audio_loss=0)),
+    dict(name="narrowband_logmel", profile="narrowband", format="logmel", utterances=[3.0],
+         limits=dict(audio_p99_ms=250, hook_p95_ms=250, cmd_p95_ms=250, result_max_ms=600, audio_loss=0)),
+    dict(name="reset_recovery", profile="reset_once", utterances=[2.5, 2.0], gap_s=1.0,
+         limits=dict(hook_p95_ms=100, result_max_ms=400, audio_loss=None, min_utterances_ok=1,
+                     min_reconnects=1)),
+]
+
+# Latency keys compared against --baseline (path into a scenario's metrics)
+BASELINE_KEYS = [
+    ("audio", "latency_ms", "p95"),
+    ("hook", "latency_ms", "p95"),
+    ("command", "latency_ms", "p95"),
+    ("result_ms", "max"),
+]
+
+
+def now_ns():
+    return time.monotonic_ns()
+
+
+def summarize(values):
+    if not values:
+        return {"n": 0}
+    v = sorted(values)
+
+    def pct(p):
+        return round(v[min(len(v) - 1, int(p * (len(v) - 1) + 0.5))], 2)
+
+    return {"n": len(v), "p50": pct(0.5), "p95": pct(0.95), "p99": pct(0.99), "max": round(v[-1], 2)}
+
+
+class MockAsr:
+    """Same replies as scripts/mock_server.py; records arrival of every frame."""
+
+    def __init__(self):
+        self.clients = set()
+        self.frames = {}          # reqId -> [(seq, latency_ms)]
+        self.commands = []        # latency_ms
+        self.server = None
+
+    async def start(self):
+        self.server = await wslite.serve(self.handler, "127.0.0.1", 0)
+        return self.server.sockets[0].getsockname()[1]
+
+    async def close(self):
+        self.server.close()
+        for c in list(self.clients):
+            c.abort()
+        for _ in range(100):
+            if not self.clients:
+                break
+            await asyncio.sleep(0.01)
+        await self.server.wait_closed()
+
+    async def handler(self, conn):
+        self.clients.add(conn)
+        req = None
+        try:
+            while True:
+                msg = await conn.recv()
+                if isinstance(msg, bytes):
+                    seq, t_ns = FRAME_HEADER.unpack_from(msg)
+                    self.frames.setdefault(req, []).append((seq, (now_ns() - t_ns) / 1e6))
+                    continue
+                data = json.loads(msg)
+                t = data.get("type")
+                if t == "start":
+                    req = data.get("reqId")
+                    self.frames.setdefault(req, [])
+                elif t == "end":
+                    await conn.send(json.dumps({"type": "ack", "reqId": data.get("reqId")}))
+                    await conn.send(json.dumps({"type": "result", "reqId": data.get("reqId"), "text": "Mock transcript"}))
+                elif t == "command" and "t_ns" in data:
+                    self.commands.append((now_ns() - data["t_ns"]) / 1e6)
+        except wslite.ConnectionClosed:
+            pass
+        finally:
+            self.clients.discard(conn)
+
+    async def broadcast_hook(self, name, hook_id):
+        ev = json.dumps({"type": "hook", "id": hook_id, "hook_event_name": name, "ts": now_ns()})
+        for c in list(self.clients):
+            try:
+                await c.send(ev)
+            except wslite.ConnectionClosed:
+                pass
+
+
+class DeviceSim:
+    """Firmware stand-in: WebSocketsClient reconnect loop + NetLink send queue."""
+
+    def __init__(self, host, port, fmt):
+        self.addr = (host, port)
+        self.chunk_bytes = LOGMEL_CHUNK_BYTES if fmt == "logmel" else CHUNK_BYTES
+        self.fmt = fmt
+        self.conn = None
+        self.connected = asyncio.Event()
+        self.stopping = False
+        self.connects = 0
+        self.queue = asyncio.Queue()     # audio + text, FIFO like NetLink's in-order drain
+        self.queue_frames = 0
+        self.recent_ids = []
+        self.hook_latency = []
+        self.hooks_received = 0
+        self.results = {}                # reqId -> arrival ns
+        self.audio = dict(generated=0, sent=0, dropped_disconnected=0, dropped_queue_full=0)
+
+    async def run(self):
+        while not self.stopping:
+            try:
+                conn = await wslite.connect(*self.addr)
+            except (OSError, asyncio.TimeoutError, wslite.ConnectionClosed):
+                await asyncio.sleep(RECONNECT_INTERVAL_S)
+                continue
+            sock = conn.writer.get_extra_info("socket")
+            sock.setsockopt(socket.SOL_SOCKET, socket.SO_SNDBUF, DEVICE_SNDBUF)
+            conn.writer.transport.set_write_buffer_limits(high=CHUNK_BYTES * 2)
+            self.conn = conn
+            self.connects += 1
+            self.connected.set()
+            sender = asyncio.create_task(self._sender(conn))
+            try:
+                await self._reader(conn)
+            finally:
+                self.connected.clear()
+                self.conn = None
+                sender.cancel()
+                self._flush_queue()
+            if not self.stopping:
+                await asyncio.sleep(RECONNECT_INTERVAL_S)
+
+    def _flush_queue(self):
+        while not self.queue.empty():
+            self.queue.get_nowait()
+        self.queue_frames = 0
+
+    async def _sender(self, conn):
+        try:
+            while True:
+                item = await self.queue.get()
+                if isinstance(item, bytes):
+                    self.queue_frames -= 1
+                if isinstance(item, dict):
+                    item = dict(item, t_ns=now_ns()) if item.get("type") == "command" else item
+                    item = json.dumps(item)
+                await conn.send(item)
+                if isinstance(item, bytes):
+                    self.audio["sent"] += 1
+        except wslite.ConnectionClosed:
+            pass
+
+    async def _reader(self, conn):
+        try:
+            while True:
+                msg = await conn.recv()
+                if not isinstance(msg, str):
+                    continue
+                data = json.loads(msg)
+                t = data.get("type")
+                if t == "hook":
+                    hid = data.get("id", "")
+                    if hid and hid in self.recent_ids:
+                        continue
+                    self.recent_ids = (self.recent_ids + [hid])[-16:]
+                    self.hooks_received += 1
+                    self.hook_latency.append((now_ns() - data["ts"]) / 1e6)
+                elif t == "result":
+                    self.results[data.get("reqId")] = now_ns()
+        except wslite.ConnectionClosed:
+            pass
+
+    def post_text(self, msg):
+        if self.connected.is_set():
+            self.queue.put_nowait(msg)
+            return True
+        return False
+
+    def post_audio(self, seq):
+        self.audio["generated"] += 1
+        if not self.connected.is_set():
+            self.audio["dropped_disconnected"] += 1
+            return
+        if self.queue_frames >= NET_AUDIO_QUEUE_LEN:
+            self.audio["dropped_queue_full"] += 1
+            return
+        frame = bytearray(self.chunk_bytes)
+        FRAME_HEADER.pack_into(frame, 0, seq, now_ns())
+        self.queue_frames += 1
+        self.queue.put_nowait(bytes(frame))
+
+    async def utterance(self, req_id, seconds, on_tick):
+        """Returns (end_sent_ns or None). on_tick(t) fires hooks/commands."""
+        try:
+            await asyncio.wait_for(self.connected.wait(), 5.0)
+        except asyncio.TimeoutError:
+            return None
+        start = {"type": "start", "reqId": req_id, "mode": "paste", "sampleRate": 16000,
+                 "channels": 1, "bitDepth": 16,
+                 "format": "logmel80_s16q8" if self.fmt == "logmel" else "pcm_s16le"}
+        if not self.post_text(start):
+            return None
+        loop = asyncio.get_running_loop()
+        t0 = loop.time()
+        n = int(seconds * 1000 / CHUNK_MS)
+        for seq in range(n):
+            await asyncio.sleep(max(0.0, t0 + (seq + 1) * CHUNK_MS / 1000.0 - loop.time()))
+            self.post_audio(seq)
+            await on_tick(seq * CHUNK_MS / 1000.0)
+        if not self.post_text({"type": "end", "reqId": req_id}):
+            return None
+        return now_ns()
+
+
+async def run_scenario(sc, seed, verbose):
+    fmt = sc.get("format", "pcm")
+    server = MockAsr()
+    server_port = await server.start()
+    proxy = ImpairedProxy("127.0.0.1", server_port, load_profile(sc["profile"]), seed=seed,
+                          log=print if verbose else None)
+    proxy_port = await proxy.start_server("127.0.0.1", 0)
+    dev = DeviceSim("127.0.0.1", proxy_port, fmt)
+    dev_task = asyncio.create_task(dev.run())
+
+    hooks_sent = 0
+    commands_sent = 0
+    utterances = []
+    try:
+        await asyncio.wait_for(dev.connected.wait(), 5.0)
+        for i, seconds in enumerate(sc["utterances"]):
+            req = f"req-{sc['name']}-{i}"
+            fired = set()
+
+            async def on_tick(t):
+                nonlocal hooks_sent, commands_sent
+                # A button command at 0.5s and a hook broadcast at 1.0s into each utterance
+                if t >= 0.5 and "cmd" not in fired:
+                    fired.add("cmd")
+                    if dev.post_text({"type": "command", "action": "approve"}):
+                        commands_sent += 1
+                if t >= 1.0 and "hook" not in fired:
+                    fired.add("hook")
+                    hooks_sent += 1
+                    await server.broadcast_hook("Stop", f"{req}-hook")
+
+            end_ns = await dev.utterance(req, seconds, on_tick)
+            utterances.append((req, end_ns))
+            if end_ns is not None:
+                deadline = time.monotonic() + 5.0
+                while req not in dev.results and time.monotonic() < deadline:
+                    await asyncio.sleep(0.005)
+            await asyncio.sleep(sc.get("gap_s", 0.3))
+        await asyncio.sleep(0.3)
+    except asyncio.TimeoutError:
+        pass
+    finally:
+        dev.stopping = True
+        if dev.conn:
+            await dev.conn.close()
+        dev_task.cancel()
+        await asyncio.gather(dev_task, return_exceptions=True)
+        await proxy.close()
+        await server.close()
+
+    # ---- metrics ----
+    received, lat, dup, reorder = 0, [], 0, 0
+    for req, _ in utterances:
+        frames = server.frames.get(req, [])
+        seen = set()
+        last = -1
+        for seq, ms in frames:
+            if seq in seen:
+                dup += 1
+                continue
+            seen.add(seq)
+            if seq < last:
+                reorder += 1
+            last = seq
+            lat.append(ms)
+        received += len(seen)
+    audio = dict(dev.audio)
+    audio.update(received=received, duplicated=dup, reordered=reorder,
+                 lost_in_flight=max(0, audio["sent"] - received),
+                 latency_ms=summarize(lat))
+    result_ms = [(dev.results[r] - e) / 1e6 for r, e in utterances if e is not None and r in dev.results]
+    metrics = dict(
+        audio=audio,
+        hook=dict(sent=hooks_sent, received=dev.hooks_received, latency_ms=summarize(dev.hook_latency)),
+        command=dict(sent=commands_sent, received=len(server.commands), latency_ms=summarize(server.commands)),
+        result_ms=summarize(result_ms),
+        utterances=dict(total=len(utterances), ok=len(result_ms)),
+        reconnects=max(0, dev.connects - 1),
+        proxy=proxy.stats(),
+    )
+    return dict(name=sc["name"], profile=sc["profile"], format=fmt, seed=seed,
+                limits=sc["limits"], metrics=metrics, failures=check(sc, metrics))
+
+
+def check(sc, m):
+    lim = sc["limits"]
+    f = []
+
+    def bound(label, value, limit):
+        if limit is not None and value is not None and value > limit:
+            f.append(f"{label} {value} > {limit}")
+
+    bound("audio p99 ms", m["audio"]["latency_ms"].get("p99"), lim.get("audio_p99_ms"))
+    bound("hook p95 ms", m["hook"]["latency_ms"].get("p95"), lim.get("hook_p95_ms"))
+    bound("command p95 ms", m["command"]["latency_ms"].get("p95"), lim.get("cmd_p95_ms"))
+    bound("result max ms", m["result_ms"].get("max"), lim.get("result_max_ms"))
+    if lim.get("audio_loss") is not None:
+        lost = m["audio"]["lost_in_flight"] + m["audio"]["dropped_queue_full"]
+        bound("audio frames lost", lost, lim["audio_loss"])
+        if m["audio"]["dropped_disconnected"]:
+            f.append(f"{m['audio']['dropped_disconnected']} frames generated while disconnected")
+    if m["audio"]["duplicated"] or m["audio"]["reordered"]:
+        f.append(f"audio duplicated {m['audio']['duplicated']} reordered {m['audio']['reordered']}")
+    ok_needed = lim.get("min_utterances_ok", m["utterances"]["total"])
+    if m["utterances"]["ok"] < ok_needed:
+        f.append(f"utterances ok {m['utterances']['ok']} < {ok_needed}")
+    if m["reconnects"] < lim.get("min_reconnects", 0):
+        f.append(f"reconnects {m['reconnects']} < {lim['min_reconnects']}")
+    if lim.get("min_reconnects") is None and m["reconnects"]:
+        f.append(f"unexpected reconnects {m['reconnects']}")
+    if lim.get("audio_loss") is not None and m["hook"]["received"] < m["hook"]["sent"]:
+        f.append(f"hooks received {m['hook']['received']} < sent {m['hook']['sent']}")
+    if lim.get("audio_loss") is not None and m["command"]["received"] < m["command"]["sent"]:
+        f.append(f"commands received {m['command']['received']} < sent {m['command']['sent']}")
+    return f
+
+
+def compare(results, baseline, tolerance, slack_ms):
+    """Latency regressions against a previous results file."""
+    base = {s["name"]: s for s in baseline.get("scenarios", [])}
+    out = []
+    for s in results:
+        b = base.get(s["name"])
+        if not b:
+            continue
+        for path in BASELINE_KEYS:
+            new, old = s["metrics"], b["metrics"]
+            for k in path:
+                new = new.get(k, {}) if isinstance(new, dict) else None
+                old = old.get(k, {}) if isinstance(old, dict) else None
+            if not isinstance(new, (int, float)) or not isinstance(old, (int, float)):
+                continue
+            if new > old * (1 + tolerance) + slack_ms:
+                msg = f"{'.'.join(path)} regressed {old} -> {new} ms"
+                s["failures"].append(msg)
+                out.append(f"{s['name']}: {msg}")
+    return out
+
+
+def git_rev():
+    try:
+        return subprocess.check_output(["git", "rev-parse", "--short", "HEAD"], stderr=subprocess.DEVNULL,
+                                       cwd=os.path.dirname(os.path.abspath(__file__))).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+async def main(args):
+    selected = [s for s in SCENARIOS if not args.only or s["name"] in args.only.split(",")]
+    results = []
+    for sc in selected:
+        r = await run_scenario(sc, args.seed, args.verbose)
+        results.append(r)
+        m = r["metrics"]
+        print(f"{'PASS' if not r['failures'] else 'FAIL'} {r['name']:<18} "
+              f"audio p99 {m['audio']['latency_ms'].get('p99', '-'):>7} ms "
+              f"rx {m['audio']['received']}/{m['audio']['generated']}  "
+              f"hook p95 {m['hook']['latency_ms'].get('p95', '-'):>6} ms  "
+              f"cmd p95 {m['command']['latency_ms'].get('p95', '-'):>6} ms  "
+              f"result max {m['result_ms'].get('max', '-'):>6} ms  reconnects {m['reconnects']}")
+        for f in r["failures"]:
+            print(f"     - {f}")
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            regressions = compare(results, json.load(f), args.tolerance, args.slack_ms)
+        for line in regressions:
+            print(f"REGRESSION {line}")
+
+    doc = dict(version=1, commit=git_rev(), seed=args.seed, generated=time.strftime("%Y-%m-%dT%H:%M:%S"),
+               passed=all(not r["failures"] for r in results), scenarios=results)
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump(doc, f, indent=2)
+        print(f"results written to {args.out}")
+    return 0 if doc["passed"] else 1
+
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--only", help="comma-separated scenario names")
+    ap.add_argument("--out", help="write JSON results here")
+    ap.add_argument("--baseline", help="previous JSON results; latency regressions fail the run")
+    ap.add_argument("--tolerance", type=float, default=0.25, help="allowed relative latency growth")
+    ap.add_argument("--slack-ms", type=float, default=5.0, help="allowed absolute latency growth")
+    ap.add_argument("--verbose", action="store_true")
+    sys.exit(asyncio.run(main(ap.parse_args())))
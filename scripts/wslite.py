@@ -0,0 +1,168 @@
+"""Minimal RFC 6455 WebSocket client/server on asyncio streams (stdlib only).
+
+Just enough for the regression harness: text/binary frames, ping/pong and
+close. No extensions, no fragmentation on send.
+"""
+import asyncio
+import base64
+import hashlib
+import os
+import struct
+
+GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+OP_CONT, OP_TEXT, OP_BINARY, OP_CLOSE, OP_PING, OP_PONG = 0x0, 0x1, 0x2, 0x8, 0x9, 0xA
+
+
+class ConnectionClosed(Exception):
+    pass
+
+
+def _accept_key(key):
+    return base64.b64encode(hashlib.sha1((key + GUID).encode()).digest()).decode()
+
+
+async def _read_headers(reader):
+    data = await reader.readuntil(b"\r\n\r\n")
+    lines = data.decode("latin-1").split("\r\n")
+    headers = {}
+    for line in lines[1:]:
+        if ":" in line:
+            k, v = line.split(":", 1)
+            headers[k.strip().lower()] = v.strip()
+    return lines[0], headers
+
+
+class WsConn:
+    def __init__(self, reader, writer, is_client):
+        self.reader = reader
+        self.writer = writer
+        self.is_client = is_client
+        self.closed = False
+        self.remote_address = writer.get_extra_info("peername")
+
+    async def _send_frame(self, opcode, payload):
+        if self.closed:
+            raise ConnectionClosed()
+        head = bytearray([0x80 | opcode])
+        mask_bit = 0x80 if self.is_client else 0
+        n = len(payload)
+        if n < 126:
+            head.append(mask_bit | n)
+        elif n < 65536:
+            head.append(mask_bit | 126)
+            head += struct.pack(">H", n)
+        else:
+            head.append(mask_bit | 127)
+            head += struct.pack(">Q", n)
+        if self.is_client:
+            mask = os.urandom(4)
+            head += mask
+            payload = bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+        try:
+            self.writer.write(bytes(head) + payload)
+            await self.writer.drain()
+        except (ConnectionError, OSError) as e:
+            self.closed = True
+            raise ConnectionClosed() from e
+
+    async def send(self, message):
+        if isinstance(message, str):
+            await self._send_frame(OP_TEXT, message.encode())
+        else:
+            await self._send_frame(OP_BINARY, bytes(message))
+
+    async def recv(self):
+        """Next text (str) or binary (bytes) message; raises ConnectionClosed."""
+        buf = bytearray()
+        msg_op = None
+        while True:
+            try:
+                b0, b1 = await self.reader.readexactly(2)
+                n = b1 & 0x7F
+                if n == 126:
+                    (n,) = struct.unpack(">H", await self.reader.readexactly(2))
+                elif n == 127:
+                    (n,) = struct.unpack(">Q", await self.reader.readexactly(8))
+                mask = await self.reader.readexactly(4) if b1 & 0x80 else None
+                payload = await self.reader.readexactly(n)
+            except (asyncio.IncompleteReadError, ConnectionError, OSError) as e:
+                self.closed = True
+                raise ConnectionClosed() from e
+            if mask:
+                payload = bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+            op = b0 & 0x0F
+            if op == OP_PING:
+                await self._send_frame(OP_PONG, payload)
+                continue
+            if op == OP_PONG:
+                continue
+            if op == OP_CLOSE:
+                if not self.closed:
+                    try:
+                        await self._send_frame(OP_CLOSE, payload[:2])
+                    except ConnectionClosed:
+                        pass
+                self.closed = True
+                raise ConnectionClosed()
+            if op != OP_CONT:
+                msg_op = op
+            buf += payload
+            if b0 & 0x80:
+                return buf.decode() if msg_op == OP_TEXT else bytes(buf)
+
+    async def close(self):
+        if not self.closed:
+            try:
+                await self._send_frame(OP_CLOSE, struct.pack(">H", 1000))
+            except ConnectionClosed:
+                pass
+        self.closed = True
+        self.writer.close()
+
+    def abort(self):
+        self.closed = True
+        self.writer.transport.abort()
+
+
+async def connect(host, port, path="/ws", timeout=5.0):
+    reader, writer = await asyncio.wait_for(asyncio.open_connection(host, port), timeout)
+    key = base64.b64encode(os.urandom(16)).decode()
+    writer.write((
+        f"GET {path} HTTP/1.1\r\nHost: {host}:{port}\r\nUpgrade: websocket\r\n"
+        f"Connection: Upgrade\r\nSec-WebSocket-Key: {key}\r\nSec-WebSocket-Version: 13\r\n\r\n"
+    ).encode())
+    await writer.drain()
+    status, headers = await asyncio.wait_for(_read_headers(reader), timeout)
+    if " 101 " not in status or headers.get("sec-websocket-accept") != _accept_key(key):
+        writer.close()
+        raise ConnectionClosed(f"handshake failed: {status}")
+    return WsConn(reader, writer, is_client=True)
+
+
+async def serve(handler, host, port):
+    """Starts a server calling `await handler(conn)` per connection."""
+
+    async def on_client(reader, writer):
+        try:
+            _, headers = await _read_headers(reader)
+            key = headers.get("sec-websocket-key")
+            if not key:
+                writer.close()
+                return
+            writer.write((
+                "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                f"Sec-WebSocket-Accept: {_accept_key(key)}\r\n\r\n"
+            ).encode())
+            await writer.drain()
+        except (asyncio.IncompleteReadError, ConnectionError, OSError):
+            writer.close()
+            return
+        conn = WsConn(reader, writer, is_client=False)
+        try:
+            await handler(conn)
+        finally:
+            if not conn.closed:
+                await conn.close()
+
+    return await asyncio.start_server(on_client, host, port)
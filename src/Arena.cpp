@@ -0,0 +1,61 @@
+#include "Arena.h"
+#include <string.h>
+
+Arena::Arena(void* buf, size_t capacity) : _buf((uint8_t*)buf), _capacity(capacity) {}
+
+void* Arena::alloc(size_t n) {
+    size_t need = blockBytes(n);
+    if (n > UINT32_MAX - ALIGN || need > _capacity - _used) {
+        _failures++;
+        return nullptr;
+    }
+    uint32_t offset = (uint32_t)_used;
+    Header* h = header(offset);
+    h->size = (uint32_t)n;
+    h->prev = _top;
+    _top = offset;
+    _used += need;
+    if (_used > _highWater) _highWater = _used;
+    _allocations++;
+    return _buf + offset + HEADER;
+}
+
+void* Arena::realloc(void* p, size_t n) {
+    if (!p) return alloc(n);
+    uint32_t offset = offsetOf(p);
+    Header* h = header(offset);
+
+    if (offset == _top) {
+        // Newest block: grow or shrink in place
+        size_t need = blockBytes(n);
+        if (n > UINT32_MAX - ALIGN || need > _capacity - offset) {
+            _failures++;
+            return nullptr;
+        }
+        h->size = (uint32_t)n;
+        _used = offset + need;
+        if (_used > _highWater) _highWater = _used;
+        return p;
+    }
+    if (n <= h->size) {
+        h->size = (uint32_t)n;   // tail stays allocated until rewind
+        return p;
+    }
+    void* q = alloc(n);
+    if (q) memcpy(q, p, h->size);
+    return q;
+}
+
+void Arena::free(void* p) {
+    if (!p) return;
+    uint32_t offset = offsetOf(p);
+    if (offset != _top) return;   // reclaimed by rewind()
+    _top = header(offset)->prev;
+    _used = offset;
+}
+
+void Arena::rewind(size_t mark) {
+    if (mark >= _used) return;
+    while (_top != NO_BLOCK && _top >= mark) _top = header(_top)->prev;
+    _used = mark;
+}
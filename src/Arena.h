@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bump allocator over a fixed buffer, for buffers that live for one message
+// (or one session) and must not touch the heap.
+//
+// Every block carries a small header (size, previous block) so realloc()
+// can copy and the top block can be found again, but only the top block
+// is ever reclaimed individually: free() and realloc() of the top block
+// work in place, anything else is released by rewinding to a mark().
+// ArenaScope rewinds when it goes out of scope.
+// Not thread safe: each arena belongs to one task.
+class Arena {
+public:
+    static constexpr size_t ALIGN = 8;
+    static constexpr size_t HEADER = ALIGN;
+
+    // Bytes one alloc(n) takes, for sizing arenas at compile time
+    static constexpr size_t blockBytes(size_t n) { return HEADER + ((n + ALIGN - 1) & ~(ALIGN - 1)); }
+
+    Arena(void* buf, size_t capacity);
+
+    // nullptr (counted in failures()) when the arena is full
+    void* alloc(size_t n);
+    void* realloc(void* p, size_t n);
+    void free(void* p);
+
+    size_t mark() const { return _used; }
+    void rewind(size_t mark);
+
+    size_t used() const { return _used; }
+    size_t capacity() const { return _capacity; }
+    size_t highWater() const { return _highWater; }
+    uint32_t allocations() const { return _allocations; }
+    uint32_t failures() const { return _failures; }
+
+private:
+    struct Header {
+        uint32_t size;   // bytes requested
+        uint32_t prev;   // offset of the previous block's header
+    };
+    static_assert(sizeof(Header) <= HEADER, "arena header does not fit");
+    static constexpr uint32_t NO_BLOCK = UINT32_MAX;
+
+    Header* header(uint32_t offset) const { return (Header*)(_buf + offset); }
+    uint32_t offsetOf(const void* p) const { return (uint32_t)((const uint8_t*)p - _buf - HEADER); }
+
+    uint8_t* _buf;
+    size_t _capacity;
+    size_t _used = 0;
+    uint32_t _top = NO_BLOCK;   // newest block
+    size_t _highWater = 0;
+    uint32_t _allocations = 0;
+    uint32_t _failures = 0;
+};
+
+template <size_t N>
+class StaticArena : public Arena {
+public:
+    StaticArena() : Arena(_storage, N) {}
+
+private:
+    alignas(Arena::ALIGN) uint8_t _storage[N];
+};
+
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& a) : _arena(a), _mark(a.mark()) {}
+    ~ArenaScope() { _arena.rewind(_mark); }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena& _arena;
+    size_t _mark;
+};
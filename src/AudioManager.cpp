@@ -1,7 +1,21 @@
 #include "AudioManager.h"
+#include "Log.h"
+
+// Defined before AudioMgr: its constructor points at m5Capture
+static M5MicCapture m5Capture;
+#if CAPTURE_I2S_DMA
+static I2sDmaCapture dmaCapture;
+#endif
+#if AUDIO_SOURCE_SYNTH
+static SynthSource synthSource;
+#endif
 
 AudioManager AudioMgr;
 
+// M5.Mic until begin() picks a back end, so the recording state machine
+// works without begin() (the on-device tests never call it)
+AudioManager::AudioManager() : _mic(&m5Capture), _source(&m5Capture) {}
+
 void AudioManager::begin() {
     auto cfg = M5.config();
     M5.begin(cfg);
@@ -13,7 +27,29 @@ void AudioManager::begin() {
 
     // Start with mic enabled, speaker disabled
     M5.Speaker.end();
-    M5.Mic.begin();
+    _mic = &m5Capture;
+#if CAPTURE_I2S_DMA
+    if (dmaCapture.begin()) {
+        _mic = &dmaCapture;
+    } else {
+        LOG_W("I2S DMA capture unavailable, using M5.Mic");
+    }
+#endif
+    _source = _mic;
+    if (_source == &m5Capture) _source->begin();
+#if AUDIO_SOURCE_SYNTH
+    synthSource.pace([]() -> uint32_t { return micros(); });
+    setSource(&synthSource);
+#endif
+    LOG_I("Audio source: %s", _source->name());
+}
+
+void AudioManager::setSource(AudioSource* source) {
+    if (!source) source = _mic;
+    if (source == _source) return;
+    _source->end();
+    _source = source;
+    if (!_source->begin()) LOG_W("Audio source %s failed to start", _source->name());
 }
 
 void AudioManager::update() {
@@ -23,7 +59,7 @@ void AudioManager::update() {
     if (!_recording) {
         static unsigned long lastLog = 0;
         if (_pendingStart > 0 && millis() - lastLog > 1000) {
-             Serial.printf("DEBUG: [Audio] Update loop. Pending Start: %d\n", _pendingStart);
+             LOG_D("DEBUG: [Audio] Update loop. Pending Start: %d", _pendingStart);
              lastLog = millis();
         }
         playPendingBeeps();
@@ -45,7 +81,7 @@ BeepPattern AudioManager::patternFor(BeepKind k) {
 }
 
 void AudioManager::queueBeep(BeepKind kind) {
-    Serial.printf("DEBUG: [Audio] Queueing kind %d. PendingStart before: %d\n", kind, _pendingStart);
+    LOG_D("DEBUG: [Audio] Queueing kind %d. PendingStart before: %d", kind, _pendingStart);
     if (kind == BEEP_STOP) _pendingStop++;
     else if (kind == BEEP_PERMISSION) _pendingPermission++;
     else if (kind == BEEP_FAILURE) _pendingFailure++;
@@ -55,16 +91,16 @@ void AudioManager::queueBeep(BeepKind kind) {
 void AudioManager::playPendingBeeps() {
     if (!_pendingStop && !_pendingPermission && !_pendingFailure && !_pendingStart) return;
 
-    Serial.printf("DEBUG: [Audio] Playing pending. Start=%d, Perm=%d, Fail=%d, Stop=%d\n", 
-                _pendingStart, _pendingPermission, _pendingFailure, _pendingStop);
+    LOG_D("DEBUG: [Audio] Playing pending. Start=%d, Perm=%d, Fail=%d, Stop=%d",
+          _pendingStart, _pendingPermission, _pendingFailure, _pendingStop);
 
     // Switch to speaker
-    M5.Mic.end();
+    _source->end();
     delay(100); // Stabilize
     M5.Speaker.begin();
     delay(100); // Stabilize
     M5.Speaker.setVolume(64);
-    Serial.printf("DEBUG: [Audio] Volume set to: %d\n", M5.Speaker.getVolume());
+    LOG_D("DEBUG: [Audio] Volume set to: %d", M5.Speaker.getVolume());
 
     auto playN = [&](BeepKind k, uint8_t n) {
         auto p = patternFor(k);
@@ -86,7 +122,7 @@ void AudioManager::playPendingBeeps() {
     _pendingStop = _pendingPermission = _pendingFailure = _pendingStart = 0;
 
     M5.Speaker.end();
-    M5.Mic.begin();
+    _source->begin();
 }
 
 uint8_t AudioManager::pendingBeeps(BeepKind kind) const {
@@ -103,21 +139,27 @@ void AudioManager::startRecording() {
     _recording = true;
     _recordStartMs = millis();
     _pendingStop = _pendingPermission = _pendingFailure = _pendingStart = 0;
+    _source->discard();
 }
 
 void AudioManager::stopRecording() {
     _recording = false;
 }
 
-bool AudioManager::recordOneChunk(int16_t* buf, size_t samples) {
-    if (!_recording) return false;
-    if (!M5.Mic.isEnabled()) return false;
+const int16_t* AudioManager::acquireChunk() {
+    if (!_recording) return nullptr;
+    if (!_source->isRunning()) return nullptr;
 
     // Check timeout
     if (millis() - _recordStartMs > MAX_RECORD_MS) {
         stopRecording();
-        return false;
+        return nullptr;
     }
 
-    return M5.Mic.record(buf, samples, SAMPLE_RATE);
+    // Bounded wait so the loop keeps servicing buttons between blocks
+    return _source->acquire(CHUNK_SAMPLES * 1000 / SAMPLE_RATE);
+}
+
+void AudioManager::releaseChunk() {
+    _source->release();
 }
@@ -2,6 +2,7 @@
 
 #include <M5Unified.h>
 #include "Config.h"
+#include "CaptureBackend.h"
 
 enum BeepKind {
     BEEP_STOP,
@@ -19,13 +20,22 @@ struct BeepPattern {
 
 class AudioManager {
 public:
+    AudioManager();
     void begin();
     void update();
     void queueBeep(BeepKind kind);
     bool isRecording() const { return _recording; }
     
-    // Returns true if a full chunk is ready in buf
-    bool recordOneChunk(int16_t* buf, size_t samples);
+    // Next CHUNK_SAMPLES block while recording, nullptr if none yet.
+    // The block is owned by the capture back end: call releaseChunk()
+    // once it has been consumed.
+    const int16_t* acquireChunk();
+    void releaseChunk();
+    const char* sourceName() const { return _source->name(); }
+    uint32_t sourceOverruns() const { return _source->overruns(); }
+    // Replaces the microphone (nullptr switches back to it). Call while
+    // not recording; the new source is started right away.
+    void setSource(AudioSource* source);
     
     void startRecording();
     void stopRecording();
@@ -37,6 +47,8 @@ private:
     BeepPattern patternFor(BeepKind k);
     void playPendingBeeps();
 
+    AudioSource* _mic;      // selected microphone back end
+    AudioSource* _source;   // what acquireChunk() reads from
     bool _recording = false;
     uint32_t _recordStartMs = 0;
     
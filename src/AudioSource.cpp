@@ -0,0 +1,234 @@
+#include "AudioSource.h"
+#include <math.h>
+#include <string.h>
+
+// ==================== GeneratorSource ====================
+
+bool GeneratorSource::begin() {
+    end();
+    if (!open()) return false;
+    _running = true;
+    _produced = 0;
+    if (_nowUs) _dueUs = _nowUs() + CHUNK_US;   // first block after one chunk, like a mic
+    return true;
+}
+
+void GeneratorSource::end() {
+    if (!_running) return;
+    close();
+    _running = false;
+}
+
+const int16_t* GeneratorSource::acquire(uint32_t timeoutMs) {
+    (void)timeoutMs;   // never waits, see pace()
+    if (!_running) return nullptr;
+    if (_nowUs) {
+        uint32_t now = _nowUs();
+        if ((int32_t)(now - _dueUs) < 0) return nullptr;
+        if (now - _dueUs > MAX_BACKLOG_US) _dueUs = now;   // stalled (beep, sleep): don't burst
+        _dueUs += CHUNK_US;
+    }
+
+    size_t n = fill(_buf, CHUNK_SAMPLES);
+    if (n == 0) {
+        end();
+        return nullptr;
+    }
+    _produced += n;
+    if (n < (size_t)CHUNK_SAMPLES) {
+        // End of stream: hand out the padded tail, then stop
+        memset(_buf + n, 0, (CHUNK_SAMPLES - n) * sizeof(int16_t));
+        end();
+    }
+    return _buf;
+}
+
+// ==================== FileSource ====================
+
+static uint16_t le16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t le32(const uint8_t* p) { return (uint32_t)le16(p) | ((uint32_t)le16(p + 2) << 16); }
+
+bool FileSource::open() {
+    if (!_path) return false;
+    _f = fopen(_path, "rb");
+    if (!_f) return false;
+
+    uint8_t riff[12];
+    _wav = fread(riff, 1, sizeof(riff), _f) == sizeof(riff) && !memcmp(riff, "RIFF", 4) && !memcmp(riff + 8, "WAVE", 4);
+    if (_wav) {
+        if (!parseWav()) {
+            close();
+            return false;
+        }
+    } else {
+        _channels = 1;
+        _dataStart = 0;
+        fseek(_f, 0, SEEK_END);
+        long size = ftell(_f);
+        _dataBytes = size > 0 ? (uint32_t)size & ~1u : 0;
+    }
+    _dataLeft = _dataBytes;
+    fseek(_f, _dataStart, SEEK_SET);
+    return true;
+}
+
+bool FileSource::parseWav() {
+    bool haveFmt = false;
+    uint8_t hdr[8];
+    while (fread(hdr, 1, sizeof(hdr), _f) == sizeof(hdr)) {
+        uint32_t size = le32(hdr + 4);
+        long next = ftell(_f) + (long)size + (long)(size & 1);   // chunks are word aligned
+
+        if (!memcmp(hdr, "fmt ", 4)) {
+            uint8_t fmt[16];
+            if (size < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), _f) != sizeof(fmt)) return false;
+            uint16_t format = le16(fmt);
+            _channels = le16(fmt + 2);
+            uint32_t rate = le32(fmt + 4);
+            uint16_t bits = le16(fmt + 14);
+            if (format != 1 || bits != 16 || rate != (uint32_t)SAMPLE_RATE) return false;
+            if (_channels != 1 && _channels != 2) return false;
+            haveFmt = true;
+        } else if (!memcmp(hdr, "data", 4)) {
+            if (!haveFmt) return false;
+            _dataStart = ftell(_f);
+            fseek(_f, 0, SEEK_END);
+            long avail = ftell(_f) - _dataStart;   // streamed WAVs may overstate the size
+            if (avail < 0) avail = 0;
+            if ((uint32_t)avail < size) size = (uint32_t)avail;
+            uint32_t frame = 2u * _channels;
+            _dataBytes = size - size % frame;
+            return true;
+        }
+        if (fseek(_f, next, SEEK_SET) != 0) return false;
+    }
+    return false;
+}
+
+void FileSource::close() {
+    if (_f) fclose(_f);
+    _f = nullptr;
+}
+
+size_t FileSource::readFrames(int16_t* out, size_t n) {
+    // Samples are little endian on disk, as on the ESP32 and the host
+    size_t avail = _dataLeft / (2u * _channels);
+    if (n > avail) n = avail;
+    if (_channels == 1) {
+        n = fread(out, sizeof(int16_t), n, _f);
+        _dataLeft -= n * 2;
+        return n;
+    }
+
+    int16_t pair[2 * 64];
+    size_t done = 0;
+    while (done < n) {
+        size_t want = n - done < 64 ? n - done : 64;
+        size_t got = fread(pair, 2 * sizeof(int16_t), want, _f);
+        for (size_t i = 0; i < got; i++) {
+            out[done + i] = (int16_t)(((int32_t)pair[2 * i] + pair[2 * i + 1]) / 2);
+        }
+        done += got;
+        _dataLeft -= got * 4;
+        if (got < want) break;
+    }
+    return done;
+}
+
+size_t FileSource::fill(int16_t* out, size_t n) {
+    size_t got = 0;
+    bool rewound = false;   // nothing read since the last rewind
+    while (got < n) {
+        size_t k = readFrames(out + got, n - got);
+        got += k;
+        if (k) {
+            rewound = false;
+            continue;
+        }
+        // Rewinding twice in a row means the data is gone (read error, file
+        // truncated under us): return the short read instead of spinning
+        if (!_loop || _dataBytes == 0 || rewound) break;
+        if (fseek(_f, _dataStart, SEEK_SET) != 0) break;
+        _dataLeft = _dataBytes;
+        rewound = true;
+    }
+    return got;
+}
+
+// ==================== SynthSource ====================
+
+static constexpr float TWO_PI_F = 6.28318530718f;
+
+bool SynthSource::open() {
+    _rng = _p.seed ? _p.seed : 1;
+    _pos = 0;
+    _phase = 0.0f;
+    _lp = 0.0f;
+    _voiced = false;
+    _segLeft = 0;
+    _segLen = 0;
+    return true;
+}
+
+float SynthSource::noise() {
+    // xorshift32, uniform in [-1, 1)
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return (int32_t)_rng * (1.0f / 2147483648.0f);
+}
+
+void SynthSource::startSegment() {
+    _voiced = !_voiced;
+    float r = noise() * 0.5f + 0.5f;   // [0, 1)
+    uint32_t ms = _voiced ? 120 + (uint32_t)(r * 280) : 60 + (uint32_t)(r * 540);
+    _segLen = _segLeft = ms * (SAMPLE_RATE / 1000);
+    if (_voiced) _pitchHz = 100.0f + (noise() * 0.5f + 0.5f) * 140.0f;
+}
+
+float SynthSource::nextSpeech() {
+    if (_segLeft == 0) startSegment();
+    _segLeft--;
+    if (!_voiced) return 0.01f * noise();   // room noise between syllables
+
+    // Syllable: band-limited sawtooth (glottal buzz) with falling pitch,
+    // raised-sine envelope and some breath noise
+    float t = (float)(_segLen - _segLeft) / (float)_segLen;
+    _phase += _pitchHz * (1.1f - 0.2f * t) / SAMPLE_RATE;
+    if (_phase >= 1.0f) _phase -= 1.0f;
+    _lp += 0.25f * ((2.0f * _phase - 1.0f) - _lp);
+    float env = sinf(3.14159265f * t);
+    return env * (0.85f * _lp + 0.1f * noise());
+}
+
+size_t SynthSource::fill(int16_t* out, size_t n) {
+    if (_p.durationMs) {
+        uint64_t total = (uint64_t)_p.durationMs * SAMPLE_RATE / 1000;
+        if (_pos >= total) return 0;
+        if (n > total - _pos) n = (size_t)(total - _pos);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        float v = 0.0f;
+        switch (_p.kind) {
+        case SYNTH_SILENCE:
+            break;
+        case SYNTH_TONE:
+            v = sinf(TWO_PI_F * _phase);
+            _phase += _p.toneHz / SAMPLE_RATE;
+            if (_phase >= 1.0f) _phase -= 1.0f;
+            break;
+        case SYNTH_NOISE:
+            v = noise();
+            break;
+        case SYNTH_SPEECH:
+            v = nextSpeech();
+            break;
+        }
+        v *= _p.amplitude * 32767.0f;
+        v = v < -32768.0f ? -32768.0f : (v > 32767.0f ? 32767.0f : v);
+        out[i] = (int16_t)lrintf(v);
+    }
+    _pos += n;
+    return n;
+}
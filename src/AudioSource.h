@@ -0,0 +1,148 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "Config.h"
+
+// Source of mono s16 audio at SAMPLE_RATE, one CHUNK_SAMPLES block at a time.
+// acquire() returns a block that stays valid until release().
+//
+// Microphone back ends live in CaptureBackend.h; the file and synthetic
+// sources below are hardware-free so the whole chunk -> frame -> send path
+// can run on the host (bench/bench_pipeline.cpp).
+class AudioSource {
+public:
+    virtual ~AudioSource() {}
+    virtual const char* name() const = 0;
+    virtual bool begin() = 0;
+    virtual void end() = 0;
+    virtual bool isRunning() const = 0;
+    // Waits up to timeoutMs for the next block; nullptr on timeout
+    virtual const int16_t* acquire(uint32_t timeoutMs) = 0;
+    virtual void release() = 0;
+    // Drops blocks captured before a new recording starts
+    virtual void discard() {}
+    // Blocks lost because the consumer fell behind
+    virtual uint32_t overruns() const { return 0; }
+};
+
+// Base for sources that produce samples on demand.
+//
+// Unpaced by default: acquire() returns the next block immediately, as
+// fast as the consumer pulls. pace(nowUs) makes it behave like a
+// microphone and hand out one block per CHUNK_SAMPLES / SAMPLE_RATE; a
+// block that is not due yet returns nullptr without waiting (the Arduino
+// loop polls again). begin() restarts the stream from the beginning.
+class GeneratorSource : public AudioSource {
+public:
+    typedef uint32_t (*ClockUs)();
+
+    void pace(ClockUs nowUs) { _nowUs = nowUs; }
+
+    bool begin() override;
+    void end() override;
+    bool isRunning() const override { return _running; }
+    const int16_t* acquire(uint32_t timeoutMs) override;
+    void release() override {}
+
+    uint64_t samplesProduced() const { return _produced; }
+
+protected:
+    virtual bool open() = 0;
+    virtual void close() {}
+    // Writes up to n samples, fewer only at the end of the stream
+    virtual size_t fill(int16_t* out, size_t n) = 0;
+
+private:
+    static constexpr uint32_t CHUNK_US = (uint32_t)((uint64_t)CHUNK_SAMPLES * 1000000 / SAMPLE_RATE);
+    static constexpr uint32_t MAX_BACKLOG_US = CHUNK_US * 4;   // catch-up limit after a stall
+
+    int16_t _buf[CHUNK_SAMPLES];
+    ClockUs _nowUs = nullptr;
+    uint32_t _dueUs = 0;
+    uint64_t _produced = 0;
+    bool _running = false;
+};
+
+// 16-bit PCM from a file through stdio (host paths, or SPIFFS / LittleFS /
+// SD mount points on the device). A RIFF header selects WAV: it must be
+// 16-bit PCM at SAMPLE_RATE, mono or stereo (stereo is averaged to mono).
+// Anything else is read as raw s16le mono. With loop, the data section
+// repeats forever; otherwise the source stops at the end (the last block
+// is zero padded).
+class FileSource : public GeneratorSource {
+public:
+    explicit FileSource(const char* path = nullptr, bool loop = false) : _path(path), _loop(loop) {}
+
+    void setPath(const char* path, bool loop) { _path = path; _loop = loop; }
+    const char* name() const override { return "file"; }
+
+    bool isWav() const { return _wav; }
+    uint16_t channels() const { return _channels; }
+    // Mono samples in one pass over the data section (0 until begin())
+    uint64_t totalSamples() const { return _dataBytes / (2u * _channels); }
+
+protected:
+    bool open() override;
+    void close() override;
+    size_t fill(int16_t* out, size_t n) override;
+
+private:
+    bool parseWav();
+    size_t readFrames(int16_t* out, size_t n);
+
+    const char* _path;
+    bool _loop;
+    FILE* _f = nullptr;
+    bool _wav = false;
+    uint16_t _channels = 1;
+    long _dataStart = 0;
+    uint32_t _dataBytes = 0;
+    uint32_t _dataLeft = 0;
+};
+
+enum SynthKind : uint8_t {
+    SYNTH_SILENCE,
+    SYNTH_TONE,     // sine at toneHz
+    SYNTH_NOISE,    // white noise
+    SYNTH_SPEECH,   // voiced bursts (harmonics + breath noise) separated by pauses
+};
+
+struct SynthParams {
+    SynthKind kind = SYNTH_SPEECH;
+    float amplitude = 0.3f;          // peak, fraction of full scale
+    float toneHz = 440.0f;
+    uint32_t seed = 1;
+    uint32_t durationMs = 0;         // 0 = endless
+};
+
+// Deterministic test signals: the same params always give the same samples.
+class SynthSource : public GeneratorSource {
+public:
+    explicit SynthSource(const SynthParams& p = SynthParams()) : _p(p) {}
+
+    void setParams(const SynthParams& p) { _p = p; }
+    const char* name() const override { return "synth"; }
+
+protected:
+    bool open() override;
+    size_t fill(int16_t* out, size_t n) override;
+
+private:
+    float noise();
+    float nextSpeech();
+    void startSegment();
+
+    SynthParams _p;
+    uint32_t _rng = 1;
+    uint64_t _pos = 0;          // samples generated
+    float _phase = 0.0f;        // tone / glottal phase, cycles
+    float _lp = 0.0f;           // glottal buzz low-pass state
+
+    // Speech: alternating voiced bursts and pauses
+    bool _voiced = false;
+    uint32_t _segLeft = 0;      // samples left in the current segment
+    uint32_t _segLen = 0;
+    float _pitchHz = 0.0f;
+};
@@ -0,0 +1,52 @@
+#include "ButtonEvents.h"
+
+bool ButtonEventQueue::accept(State& s, bool pressed, uint32_t tsUs, uint8_t button, ButtonPress& press) {
+    s.pressed = pressed;
+    s.seen = true;
+    s.changedUs = tsUs;
+    if (!pressed) return false;
+    press = {button, tsUs};
+    return true;
+}
+
+bool ButtonEventQueue::onEdge(const ButtonEdge& e, ButtonPress& press) {
+    if (e.button >= MAX_BUTTONS) return false;
+    State& s = _state[e.button];
+    s.rawLevel = e.level;
+    s.rawTsUs = e.tsUs;
+
+    bool wantPressed = !e.level;
+    if (wantPressed == s.pressed) return false;                          // bounced back
+    if (s.seen && (int32_t)(e.tsUs - s.changedUs) < (int32_t)_debounceUs) return false;  // inside lockout
+    return accept(s, wantPressed, e.tsUs, e.button, press);
+}
+
+bool ButtonEventQueue::settle(uint8_t button, uint32_t nowUs, ButtonPress& press) {
+    State& s = _state[button];
+    bool wantPressed = !s.rawLevel;
+    if (wantPressed == s.pressed) return false;
+    if ((int32_t)(nowUs - s.changedUs) < (int32_t)_debounceUs) return false;
+    // Level changed during the lockout and stayed there: the change really
+    // happened at the last raw edge, but the next lockout starts now.
+    bool produced = accept(s, wantPressed, s.rawTsUs, button, press);
+    s.changedUs = nowUs;
+    return produced;
+}
+
+size_t ButtonEventQueue::poll(uint32_t nowUs, ButtonPress* out, size_t maxOut) {
+    size_t n = 0;
+    ButtonEdge e;
+    ButtonPress p;
+
+    // Stop draining when the output is full; remaining edges wait for the next poll.
+    while (n < maxOut) {
+        if (!_edges.pop(e)) break;
+        if (onEdge(e, p)) out[n++] = p;
+    }
+    // Only settle against a fully drained queue, otherwise rawLevel may be stale.
+    if (!_edges.empty()) return n;
+    for (uint8_t b = 0; b < MAX_BUTTONS && n < maxOut; b++) {
+        if (settle(b, nowUs, p)) out[n++] = p;
+    }
+    return n;
+}
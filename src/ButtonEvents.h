@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Config.h"
+#include "SpscQueue.h"
+
+// Raw edge captured in the GPIO ISR. Buttons are active LOW, so
+// level == false means the contact is closed.
+struct ButtonEdge {
+    uint8_t button;
+    bool level;
+    uint32_t tsUs;
+};
+
+// Debounced press. tsUs is the timestamp of the edge that started it,
+// so callers can measure press-to-send latency.
+struct ButtonPress {
+    uint8_t button;
+    uint32_t tsUs;
+};
+
+// ISR edge queue + timestamp debouncer. Hardware-free so it can be driven
+// with synthetic edge sequences on the host.
+//
+// Debounce: the first edge of a change is accepted immediately (no added
+// latency); further edges within BUTTON_DEBOUNCE_US are treated as bounce.
+// If the level settled on the other state during that window, poll()
+// accepts it once the window has passed.
+class ButtonEventQueue {
+public:
+    static constexpr uint8_t MAX_BUTTONS = 8;
+
+    explicit ButtonEventQueue(uint32_t debounceUs = BUTTON_DEBOUNCE_US) : _debounceUs(debounceUs) {}
+
+    // ISR side
+    bool pushEdge(uint8_t button, bool level, uint32_t tsUs) {
+        return _edges.push(ButtonEdge{button, level, tsUs});
+    }
+
+    // Loop side: drains queued edges and returns up to maxOut debounced presses.
+    size_t poll(uint32_t nowUs, ButtonPress* out, size_t maxOut);
+
+    bool isPressed(uint8_t button) const { return button < MAX_BUTTONS && _state[button].pressed; }
+    uint32_t droppedEdges() const { return _edges.dropped(); }
+
+private:
+    struct State {
+        bool pressed = false;
+        bool seen = false;       // any accepted change yet
+        bool rawLevel = true;    // last level reported by the ISR
+        uint32_t rawTsUs = 0;
+        uint32_t changedUs = 0;  // time of last accepted change
+    };
+
+    bool onEdge(const ButtonEdge& e, ButtonPress& press);
+    bool settle(uint8_t button, uint32_t nowUs, ButtonPress& press);
+    bool accept(State& s, bool pressed, uint32_t tsUs, uint8_t button, ButtonPress& press);
+
+    uint32_t _debounceUs;
+    SpscQueue<ButtonEdge, BUTTON_EDGE_QUEUE_LEN> _edges;
+    State _state[MAX_BUTTONS];
+};
@@ -0,0 +1,22 @@
+#include "ButtonInput.h"
+
+ButtonInput ButtonIn;
+
+void IRAM_ATTR ButtonInput::onEdgeISR(void* arg) {
+    uint8_t idx = (uint8_t)(uintptr_t)arg;
+    ButtonIn._events.pushEdge(idx, digitalRead(ButtonIn._pins[idx]), micros());
+}
+
+void ButtonInput::begin(const uint8_t* pins, uint8_t count) {
+    if (count > ButtonEventQueue::MAX_BUTTONS) count = ButtonEventQueue::MAX_BUTTONS;
+    _count = count;
+    for (uint8_t i = 0; i < count; i++) {
+        _pins[i] = pins[i];
+        pinMode(pins[i], INPUT_PULLUP);
+        attachInterruptArg(digitalPinToInterrupt(pins[i]), onEdgeISR, (void*)(uintptr_t)i, CHANGE);
+    }
+}
+
+size_t ButtonInput::poll(ButtonPress* out, size_t maxOut) {
+    return _events.poll(micros(), out, maxOut);
+}
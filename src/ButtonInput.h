@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Arduino.h>
+#include "ButtonEvents.h"
+
+// Interrupt-driven external buttons. GPIO ISRs push timestamped edges into a
+// lock-free queue; poll() debounces them from the loop, so presses are not
+// lost while the loop is blocked (beeps, mDNS, sendBIN).
+class ButtonInput {
+public:
+    void begin(const uint8_t* pins, uint8_t count);
+
+    // Returns debounced presses since the last call (up to maxOut).
+    // Pass ButtonPress::tsUs with the command: the network task records
+    // press-to-send once the message is on the socket.
+    size_t poll(ButtonPress* out, size_t maxOut);
+
+    uint32_t droppedEdges() const { return _events.droppedEdges(); }
+
+private:
+    static void IRAM_ATTR onEdgeISR(void* arg);
+
+    ButtonEventQueue _events;
+    uint8_t _pins[ButtonEventQueue::MAX_BUTTONS] = {};
+    uint8_t _count = 0;
+};
+
+extern ButtonInput ButtonIn;
@@ -0,0 +1,214 @@
+#include "CaptureBackend.h"
+
+const int16_t* M5MicCapture::acquire(uint32_t timeoutMs) {
+    (void)timeoutMs;   // M5.Mic.record() blocks until its queue has room
+    if (!M5.Mic.record(_buf, CHUNK_SAMPLES, SAMPLE_RATE)) return nullptr;
+    return _buf;
+}
+
+#if CAPTURE_I2S_DMA
+// ==================== I2sDmaCapture: shared ====================
+
+// Copies M5.Mic's post-processing settings and releases its I2S port.
+// false if this back end cannot drive the mic (codec, PDM or ADC; see
+// CaptureBackend.h).
+bool I2sDmaCapture::takeOverMic() {
+    auto mc = M5.Mic.config();
+    if (!i2sDmaCanDrive({mc.pin_mck, mc.pin_bck, mc.use_adc, mc.left_channel})) return false;
+    M5.Mic.end();
+    _gain = mc.magnification ? mc.magnification : 1;
+    _filter = mc.noise_filter_level;
+    _dcQ8 = 0;
+    _prev = 0;
+    return true;
+}
+
+void I2sDmaCapture::condition(int16_t* buf) {
+    for (int i = 0; i < CHUNK_SAMPLES; i++) {
+        int32_t v = buf[i];
+        _dcQ8 += (v * 256 - _dcQ8) >> 10;   // ~64 ms time constant
+        v = (v - (_dcQ8 >> 8)) * _gain;
+        v = v < -32768 ? -32768 : (v > 32767 ? 32767 : v);
+        if (_filter) v = (v * (256 - _filter) + _prev * _filter) >> 8;
+        _prev = v;
+        buf[i] = (int16_t)v;
+    }
+}
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+// ==================== I2sDmaCapture: IDF 5 i2s_std ====================
+
+bool IRAM_ATTR I2sDmaCapture::onRecv(i2s_chan_handle_t handle, i2s_event_data_t* event, void* ctx) {
+    (void)handle;
+    auto* self = static_cast<I2sDmaCapture*>(ctx);
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+    const int16_t* buf = static_cast<const int16_t*>(event->dma_buf);
+#else
+    const int16_t* buf = *static_cast<const int16_t* const*>(event->data);   // pointer to the buffer pointer
+#endif
+    self->_ring.onComplete(buf);
+
+    BaseType_t woken = pdFALSE;
+    if (self->_consumer) vTaskNotifyGiveFromISR(self->_consumer, &woken);
+    return woken == pdTRUE;
+}
+
+bool I2sDmaCapture::begin() {
+    if (_rx) return true;
+    if (!takeOverMic()) return false;
+    auto mc = M5.Mic.config();
+
+    i2s_chan_config_t chanCfg = I2S_CHANNEL_DEFAULT_CONFIG((i2s_port_t)mc.i2s_port, I2S_ROLE_MASTER);
+    chanCfg.dma_desc_num = I2S_DMA_DESC_NUM;
+    chanCfg.dma_frame_num = CHUNK_SAMPLES;   // one descriptor == one chunk (mono 16-bit)
+    chanCfg.auto_clear = false;
+    if (i2s_new_channel(&chanCfg, nullptr, &_rx) != ESP_OK) {
+        _rx = nullptr;
+        return false;
+    }
+
+    i2s_std_config_t stdCfg = {};
+    stdCfg.clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE);
+    stdCfg.slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_MONO);
+    stdCfg.slot_cfg.slot_mask = mc.left_channel ? I2S_STD_SLOT_LEFT : I2S_STD_SLOT_RIGHT;
+    stdCfg.gpio_cfg.mclk = I2S_GPIO_UNUSED;
+    stdCfg.gpio_cfg.bclk = (gpio_num_t)mc.pin_bck;
+    stdCfg.gpio_cfg.ws = (gpio_num_t)mc.pin_ws;
+    stdCfg.gpio_cfg.dout = I2S_GPIO_UNUSED;
+    stdCfg.gpio_cfg.din = (gpio_num_t)mc.pin_data_in;
+
+    i2s_event_callbacks_t cbs = {};
+    cbs.on_recv = onRecv;
+
+    _ring.reset();
+    _consumer = xTaskGetCurrentTaskHandle();
+    if (i2s_channel_init_std_mode(_rx, &stdCfg) != ESP_OK ||
+        i2s_channel_register_event_callback(_rx, &cbs, this) != ESP_OK ||
+        i2s_channel_enable(_rx) != ESP_OK) {
+        i2s_del_channel(_rx);
+        _rx = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void I2sDmaCapture::end() {
+    if (!_rx) return;
+    i2s_channel_disable(_rx);
+    i2s_del_channel(_rx);
+    _rx = nullptr;
+    _ring.reset();
+}
+
+bool I2sDmaCapture::isRunning() const {
+    return _rx != nullptr;
+}
+
+const int16_t* I2sDmaCapture::acquire(uint32_t timeoutMs) {
+    if (!_rx) return nullptr;
+    const int16_t* block = _ring.acquire();
+    if (!block) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+        block = _ring.acquire();
+    }
+    // The descriptor buffer is not rewritten until the DMA laps it
+    if (block) condition(const_cast<int16_t*>(block));
+    return block;
+}
+
+void I2sDmaCapture::release() {
+    _ring.release();   // a block lapped while held is counted in overruns()
+}
+
+void I2sDmaCapture::discard() {
+    _ring.reset();
+}
+
+uint32_t I2sDmaCapture::overruns() const {
+    return _ring.overruns();
+}
+
+#else
+// ==================== I2sDmaCapture: IDF 4.4 legacy driver ====================
+
+bool I2sDmaCapture::begin() {
+    if (_events) return true;
+    if (!takeOverMic()) return false;
+    auto mc = M5.Mic.config();
+    _port = (i2s_port_t)mc.i2s_port;
+
+    i2s_config_t cfg = {};
+    cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX);
+    cfg.sample_rate = SAMPLE_RATE;
+    cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    cfg.channel_format = mc.left_channel ? I2S_CHANNEL_FMT_ONLY_LEFT : I2S_CHANNEL_FMT_ONLY_RIGHT;
+    cfg.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    cfg.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    cfg.dma_buf_count = I2S_DMA_DESC_NUM;
+    cfg.dma_buf_len = CHUNK_SAMPLES;   // one descriptor == one chunk (mono 16-bit)
+    if (i2s_driver_install(_port, &cfg, I2S_DMA_DESC_NUM, &_events) != ESP_OK) {
+        _events = nullptr;
+        return false;
+    }
+
+    i2s_pin_config_t pins = {};
+    pins.mck_io_num = I2S_PIN_NO_CHANGE;
+    pins.bck_io_num = mc.pin_bck;
+    pins.ws_io_num = mc.pin_ws;
+    pins.data_out_num = I2S_PIN_NO_CHANGE;
+    pins.data_in_num = mc.pin_data_in;
+    if (i2s_set_pin(_port, &pins) != ESP_OK) {
+        i2s_driver_uninstall(_port);
+        _events = nullptr;
+        return false;
+    }
+    _fill = 0;
+    _overruns = 0;
+    return true;
+}
+
+void I2sDmaCapture::end() {
+    if (!_events) return;
+    i2s_driver_uninstall(_port);
+    _events = nullptr;
+}
+
+bool I2sDmaCapture::isRunning() const {
+    return _events != nullptr;
+}
+
+const int16_t* I2sDmaCapture::acquire(uint32_t timeoutMs) {
+    if (!_events) return nullptr;
+    i2s_event_t ev;
+    while (xQueueReceive(_events, &ev, 0) == pdTRUE) {
+        if (ev.type == I2S_EVENT_RX_Q_OVF) _overruns++;   // driver dropped its oldest buffer
+    }
+
+    size_t got = 0;
+    i2s_read(_port, (uint8_t*)_buf + _fill, CHUNK_BYTES - _fill, &got, pdMS_TO_TICKS(timeoutMs));
+    _fill += got;
+    if (_fill < (size_t)CHUNK_BYTES) return nullptr;
+    _fill = 0;
+    condition(_buf);
+    return _buf;
+}
+
+void I2sDmaCapture::release() {}
+
+void I2sDmaCapture::discard() {
+    if (!_events) return;
+    // Read out whatever the DMA buffers hold; bounded by the descriptor count
+    size_t got = CHUNK_BYTES;
+    for (uint32_t i = 0; i <= I2S_DMA_DESC_NUM && got == (size_t)CHUNK_BYTES; i++) {
+        i2s_read(_port, _buf, CHUNK_BYTES, &got, 0);
+    }
+    xQueueReset(_events);
+    _fill = 0;
+    _overruns = 0;
+}
+
+uint32_t I2sDmaCapture::overruns() const {
+    return _overruns;
+}
+#endif
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <M5Unified.h>
+#include "Config.h"
+#include "AudioSource.h"
+#include "CapturePolicy.h"
+#include "DmaRing.h"
+#if CAPTURE_I2S_DMA
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <driver/i2s_std.h>
+#else
+#include <driver/i2s.h>   // legacy driver (Arduino core 2.x / IDF 4.4)
+#endif
+#endif
+
+// Microphone back ends for AudioManager (interface in AudioSource.h).
+
+// M5Unified path: M5.Mic.record() into our own buffer (one copy).
+class M5MicCapture : public AudioSource {
+public:
+    const char* name() const override { return "m5"; }
+    bool begin() override { return M5.Mic.begin(); }
+    void end() override { M5.Mic.end(); }
+    bool isRunning() const override { return M5.Mic.isEnabled(); }
+    const int16_t* acquire(uint32_t timeoutMs) override;
+    void release() override {}
+
+private:
+    int16_t _buf[CHUNK_SAMPLES];
+};
+
+#if CAPTURE_I2S_DMA
+// Direct I2S standard-mode RX, one DMA descriptor per chunk. Pins and port
+// come from M5.Mic.config(), so M5.Mic must not be running at the same time.
+//
+// IDF 5: the RX callback hands each descriptor buffer to a DmaRing and the
+// consumer reads it in place (zero copy). IDF 4.4 has no per-descriptor
+// callback, so the legacy driver's i2s_read() copies one chunk out instead
+// and overruns come from its RX queue overflow events.
+//
+// M5.Mic post-processes its samples (DC offset, magnification, noise
+// filter); condition() applies the same steps from M5.Mic.config() so both
+// back ends deliver the same level. Mics behind a codec (MCLK pin set, e.g.
+// the ES8311 on Atom EchoS3R) are powered by M5.Mic's enable callback,
+// which M5Unified does not expose; PDM and ADC mics need a different
+// driver mode. begin() refuses all three (i2sDmaCanDrive) and AudioManager
+// stays on M5.Mic. The mono slot follows M5.Mic's left_channel.
+class I2sDmaCapture : public AudioSource {
+public:
+    const char* name() const override { return "i2s_dma"; }
+    bool begin() override;
+    void end() override;
+    bool isRunning() const override;
+    const int16_t* acquire(uint32_t timeoutMs) override;
+    void release() override;
+    void discard() override;
+    uint32_t overruns() const override;
+
+private:
+    bool takeOverMic();
+    void condition(int16_t* buf);
+
+    int32_t _dcQ8 = 0;          // DC offset estimate, 1/256 LSB
+    int32_t _prev = 0;          // noise filter state
+    int32_t _gain = 1;          // M5.Mic magnification
+    int32_t _filter = 0;        // M5.Mic noise_filter_level, 0..255
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+    static bool IRAM_ATTR onRecv(i2s_chan_handle_t handle, i2s_event_data_t* event, void* ctx);
+
+    i2s_chan_handle_t _rx = nullptr;
+    TaskHandle_t _consumer = nullptr;
+    DmaRing _ring{I2S_DMA_DESC_NUM};
+#else
+    i2s_port_t _port = I2S_NUM_0;
+    QueueHandle_t _events = nullptr;   // non-null while installed
+    int16_t _buf[CHUNK_SAMPLES];
+    size_t _fill = 0;                  // bytes of _buf read so far
+    uint32_t _overruns = 0;
+#endif
+};
+#endif
@@ -0,0 +1,8 @@
+#include "CapturePolicy.h"
+
+bool i2sDmaCanDrive(const MicPins& mic) {
+    if (mic.use_adc) return false;
+    if (mic.pin_mck >= 0) return false;
+    if (mic.pin_bck < 0) return false;
+    return true;
+}
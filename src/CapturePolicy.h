@@ -0,0 +1,14 @@
+#pragma once
+
+// Which M5.Mic configurations I2sDmaCapture can drive itself. Pure logic on
+// the fields of M5.Mic.config(), so it is tested on the host.
+struct MicPins {
+    int pin_mck;        // set: mic behind a codec, powered by M5.Mic's enable callback
+    int pin_bck;        // unset: PDM mic (clock on the WS pin)
+    bool use_adc;       // analog mic on the ADC, not I2S at all
+    bool left_channel;  // which standard-mode slot carries the samples
+};
+
+// true only for a plain standard-mode I2S mic: no codec, not PDM, not ADC.
+// Anything else stays on M5.Mic.
+bool i2sDmaCanDrive(const MicPins& mic);
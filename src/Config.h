@@ -1,7 +1,11 @@
 #pragma once
 
+#ifdef ARDUINO
 #include <Arduino.h>
 #include "secrets.h"   // WiFi credentials, WS_HOSTNAME, AUTH_TOKEN (gitignored)
+#else
+#include <stdint.h>    // Host (native) builds: constants only, no secrets
+#endif
 
 // WebSocket Configuration
 // WS_HOSTNAME is defined in secrets.h (or via build_flags).
@@ -10,9 +14,9 @@
 #define WS_HOSTNAME "your-hostname.local"
 #endif
 
-static const char *WS_HOST = WS_HOSTNAME;
-static const uint16_t WS_PORT = 8765;
-static const char *WS_PATH = "/ws";
+static constexpr const char *WS_HOST = WS_HOSTNAME;
+static constexpr uint16_t WS_PORT = 8765;
+static constexpr const char *WS_PATH = "/ws";
 
 // Audio Configuration
 static constexpr int SAMPLE_RATE = 16000;
@@ -24,6 +28,91 @@ static constexpr const char *FORMAT = "pcm_s16le";
 static constexpr int CHUNK_SAMPLES = 320;
 static constexpr int CHUNK_BYTES = CHUNK_SAMPLES * (BIT_DEPTH / 8) * CHANNELS;
 
+// Capture back end: 0 = M5.Mic.record (default), 1 = direct I2S DMA ring
+// (zero-copy on IDF 5, one i2s_read() copy on IDF 4.4; falls back to M5 if
+// the mic sits behind a codec or the I2S port cannot be set up).
+#ifndef CAPTURE_I2S_DMA
+#define CAPTURE_I2S_DMA 0
+#endif
+// DMA descriptors in the capture ring, one CHUNK_SAMPLES block each (6 = 120ms slack)
+static constexpr uint32_t I2S_DMA_DESC_NUM = 6;
+static constexpr uint32_t I2S_DMA_READY_QUEUE_LEN = 8;   // power of two >= I2S_DMA_DESC_NUM
+
+// Audio source: 0 = microphone (default), 1 = synthetic speech-like bursts
+// paced at real time, for exercising the upload path without talking.
+#ifndef AUDIO_SOURCE_SYNTH
+#define AUDIO_SOURCE_SYNTH 0
+#endif
+
+// Optional log-mel upload (whisper front end computed on-device) instead of PCM.
+// Enable with build_flags: -DUPLOAD_LOGMEL=1
+#ifndef UPLOAD_LOGMEL
+#define UPLOAD_LOGMEL 0
+#endif
+static constexpr const char *LOGMEL_FORMAT = "logmel80_s16q8";
+// Whisper framing: 400-point STFT (25ms), 10ms hop, 80 Slaney mel bins
+static constexpr int MEL_N_FFT = 400;
+static constexpr int MEL_HOP = 160;
+static constexpr int MEL_BINS = 80;
+static constexpr int MEL_FFT_BINS = MEL_N_FFT / 2 + 1;
+// Upload encoding: int16 = round(log10(mel) * MEL_Q_SCALE)
+static constexpr int MEL_Q_SCALE = 256;
+// One PCM chunk yields at most this many feature frames (streaming carry-over)
+static constexpr int MEL_FRAMES_PER_CHUNK_MAX = CHUNK_SAMPLES / MEL_HOP + 1;
+static_assert(MEL_FRAMES_PER_CHUNK_MAX * MEL_BINS * 2 <= CHUNK_BYTES,
+              "feature frames for one chunk must fit an audio frame slot");
+
+// Network task: AppNetworkManager runs pinned to the core the Arduino loop is not on
+static constexpr int NET_TASK_CORE = 0;
+static constexpr uint32_t NET_TASK_STACK = 8192;
+static constexpr int NET_TASK_PRIORITY = 2;
+// Cross-core queues (powers of two). 16 audio frames = 320ms of buffering.
+static constexpr uint32_t NET_AUDIO_QUEUE_LEN = 16;
+static constexpr uint32_t NET_CMD_QUEUE_LEN = 8;
+static constexpr uint32_t NET_HOOK_QUEUE_LEN = 8;
+static constexpr int REQ_ID_MAX_LEN = 40;
+static constexpr int HOOK_NAME_MAX_LEN = 32;
+
+// Memory budget (MemoryBudget.h): per-session and per-message buffers are
+// static, sized from these, and the total is checked at compile time.
+// Outbound JSON (start is the longest message)
+static constexpr uint32_t JSON_OUT_MAX_LEN = 384;
+// One ArduinoJson variant pool (ARDUINOJSON_POOL_CAPACITY slots, set per env
+// in platformio.ini so the pool is this size on the ESP32 and on the host;
+// checked in JsonArena.h)
+static constexpr uint32_t JSON_VARIANT_POOL_BYTES = 1024;
+// Filter document (kept for the life of the network task): one pool, keys are
+// literals stored by pointer. One filtered inbound message: one pool, the kept
+// strings and the parser's key buffer. Estimates, not yet measured: set both
+// from the peaks the host soak test prints (pio test -e native).
+static constexpr uint32_t JSON_FILTER_POOL_BYTES = JSON_VARIANT_POOL_BYTES + 256;
+static constexpr uint32_t JSON_DOC_POOL_BYTES = JSON_VARIANT_POOL_BYTES + 1024;
+// Hook event de-dup: last HOOK_ID_DEDUP ids, compared up to HOOK_ID_MAX_LEN - 1 chars
+static constexpr int HOOK_ID_DEDUP = 16;
+static constexpr int HOOK_ID_MAX_LEN = 48;
+// Everything in MemoryBudget.h must fit in this
+static constexpr uint32_t APP_RAM_BUDGET_BYTES = 48 * 1024;
+// Metrics summary on serial
+static constexpr uint32_t METRICS_LOG_INTERVAL_MS = 60000;
+
+// Deferred logger (Log.h). Levels above LOG_LEVEL compile to nothing;
+// enable debug output with build_flags: -DLOG_LEVEL=4
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+static constexpr uint32_t LOG_RING_LEN = 32;       // records, power of two
+static constexpr int LOG_MAX_ARGS = 6;
+static constexpr int LOG_TEXT_BYTES = 64;          // copied %s arguments per record, truncated
+static constexpr int LOG_LINE_MAX = 192;
+static constexpr int LOG_TASK_CORE = 0;
+static constexpr uint32_t LOG_TASK_STACK = 4096;
+static constexpr int LOG_TASK_PRIORITY = 1;         // below the network task
+
 // Recording duration cap (safety)
 static constexpr uint32_t MAX_RECORD_MS = 8000;
 
@@ -33,6 +122,12 @@ static constexpr uint32_t MAX_RECORD_MS = 8000;
 #define BTN_BACKSPACE_PIN    7
 #define BTN_AUTO_APPROVE_PIN 8
 
+// Button edges are timestamped in the GPIO ISR and debounced on those timestamps.
+// Debounce window: edges within this time after an accepted change are bounce.
+static constexpr uint32_t BUTTON_DEBOUNCE_US = 15000;  // 15ms
+// ISR -> loop edge queue depth (power of two)
+static constexpr uint32_t BUTTON_EDGE_QUEUE_LEN = 32;
+
 // Keep-alive: prevent power bank auto-standby
 // Pulse interval: how often to draw current (ms)
 static constexpr uint32_t KEEPALIVE_PULSE_INTERVAL_MS = 30000;  // 30 seconds
@@ -43,5 +138,40 @@ static constexpr uint32_t KEEPALIVE_IDLE_TIMEOUT_MS = 3600000;  // 1 hour
 // GPIO pin for load (use onboard LED or external resistor)
 #define KEEPALIVE_PIN 48  // ESP32-S3 onboard RGB LED data pin (or change to your pin)
 
+// Power policy (see PowerPolicy.h). Idle times count from the last button press.
+// Stay in full performance this long after a button press
+static constexpr uint32_t POWER_ACTIVE_HOLD_MS = 10000;        // 10 seconds
+// BtnA pre-warm: radio held at full performance while the recording starts
+static constexpr uint32_t POWER_PREWARM_HOLD_MS = 3000;        // 3 seconds
+// Modem sleep -> light sleep (max modem sleep + 80 MHz CPU) after this idle time
+static constexpr uint32_t POWER_LIGHT_SLEEP_AFTER_MS = 60000;  // 1 minute
+// Light sleep -> deep sleep (woken by the external buttons)
+static constexpr uint32_t AUTO_SHUTDOWN_MS = 5 * 60 * 1000;    // 5 minutes
+// Fast resume: give up on the cached AP (BSSID/channel) after this long and scan
+static constexpr uint32_t RESUME_WIFI_TIMEOUT_MS = 3000;
+// Fast resume: fall back to full mDNS resolution if the cached server IP
+// has not produced a WS connection within this time
+static constexpr uint32_t RESUME_WS_TIMEOUT_MS = 5000;
+
+// Roaming between WIFI_NETWORKS BSSIDs while idle (see RoamPolicy.h)
+// RSSI sampling period and smoothing (EMA weight of a new sample)
+static constexpr uint32_t ROAM_SAMPLE_MS = 1000;
+static constexpr float ROAM_RSSI_ALPHA = 0.25f;
+static constexpr int ROAM_MIN_SAMPLES = 5;
+// Scan when the smoothed RSSI drops below this, or too many sends fail
+static constexpr int ROAM_RSSI_TRIGGER_DBM = -70;
+static constexpr float ROAM_TX_FAIL_TRIGGER = 0.10f;     // EMA of sendBIN failures
+// A candidate must beat the current smoothed RSSI by this much
+static constexpr int ROAM_HYSTERESIS_DB = 8;
+// Quiet periods: after an utterance, between scans, after a roam
+static constexpr uint32_t ROAM_IDLE_AFTER_MS = 2000;
+static constexpr uint32_t ROAM_SCAN_INTERVAL_MS = 30000;
+static constexpr uint32_t ROAM_COOLDOWN_MS = 60000;
+// Scan results older than this are not acted on
+static constexpr uint32_t ROAM_SCAN_MAX_AGE_MS = 5000;
+// Association timeout for the target BSSID before falling back to WiFiMulti
+static constexpr uint32_t ROAM_CONNECT_TIMEOUT_MS = 3000;
+static constexpr int ROAM_MAX_CANDIDATES = 8;
+
 // mDNS periodic re-resolution interval (in case server IP changes)
 static constexpr uint32_t MDNS_RECHECK_INTERVAL_MS = 300000;  // 5 minutes
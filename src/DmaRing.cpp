@@ -0,0 +1,36 @@
+#include "DmaRing.h"
+
+static_assert(I2S_DMA_DESC_NUM >= 2, "DMA ring needs at least two descriptors");
+static_assert(I2S_DMA_DESC_NUM <= I2S_DMA_READY_QUEUE_LEN, "ready queue must cover every descriptor");
+
+const int16_t* DmaRing::acquire() {
+    if (_held.data) return _held.data;   // not released yet
+
+    DmaBlock b;
+    while (_ready.pop(b)) {
+        if (overwritten(b.seq)) {
+            _lapped++;                   // consumer fell behind: drop stale block
+            continue;
+        }
+        _held = b;
+        return b.data;
+    }
+    return nullptr;
+}
+
+bool DmaRing::release() {
+    if (!_held.data) return true;
+    bool intact = !overwritten(_held.seq);
+    if (!intact) _lapped++;
+    _held.data = nullptr;
+    return intact;
+}
+
+void DmaRing::reset() {
+    DmaBlock b;
+    while (_ready.pop(b)) {
+    }
+    _held.data = nullptr;
+    _lapped = 0;
+    _droppedBase = _ready.dropped();
+}
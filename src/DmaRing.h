@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include "Config.h"
+#include "SpscQueue.h"
+
+// Zero-copy hand-off of completed I2S DMA descriptor buffers.
+//
+// The DMA engine cycles through `descriptors` buffers forever and cannot be
+// held back, so instead of owning buffers the ring tracks completion
+// sequence numbers: the buffer completed as sequence s is rewritten once
+// sequence s + descriptors - 1 has completed and the engine moves on to it.
+// acquire() skips blocks that were already lapped, and release() reports
+// whether the block was overwritten while the consumer held it. Both count
+// as overruns.
+//
+// onComplete() runs in the DMA ISR; acquire()/release() on one consumer task.
+class DmaRing {
+public:
+    explicit DmaRing(uint32_t descriptors = I2S_DMA_DESC_NUM) : _descriptors(descriptors) {}
+
+    // ISR: DMA finished filling `buf` and has started on the next descriptor
+    void onComplete(const int16_t* buf) {
+        uint32_t seq = _completed.load(std::memory_order_relaxed);
+        _completed.store(seq + 1, std::memory_order_release);
+        _ready.push(DmaBlock{buf, seq});   // full queue: counted in overruns()
+    }
+
+    // Oldest intact completed block, or nullptr. Valid until release().
+    const int16_t* acquire();
+    // Returns false if the DMA overwrote the block while it was held.
+    bool release();
+
+    uint32_t overruns() const { return _lapped + (_ready.dropped() - _droppedBase); }
+    uint32_t completed() const { return _completed.load(std::memory_order_acquire); }
+    size_t pending() const { return _ready.size(); }
+    // Consumer: drop everything queued (e.g. blocks captured while idle)
+    // and start counting overruns from zero.
+    void reset();
+
+private:
+    struct DmaBlock {
+        const int16_t* data;
+        uint32_t seq;
+    };
+
+    bool overwritten(uint32_t seq) const {
+        return completed() - seq >= _descriptors;
+    }
+
+    uint32_t _descriptors;
+    SpscQueue<DmaBlock, I2S_DMA_READY_QUEUE_LEN> _ready;
+    std::atomic<uint32_t> _completed{0};
+
+    // Consumer side only
+    DmaBlock _held = {nullptr, 0};
+    uint32_t _lapped = 0;
+    uint32_t _droppedBase = 0;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include "Arena.h"
+#include "Config.h"
+
+// The JSON_* budgets in Config.h assume ArduinoJson 7.3+ (string literals kept
+// by pointer) and one variant pool of JSON_VARIANT_POOL_BYTES: 8-byte slots on
+// 32-bit targets, 16-byte on 64-bit hosts.
+static_assert(ARDUINOJSON_VERSION_MAJOR == 7 && ARDUINOJSON_VERSION_MINOR >= 3,
+              "JSON_* budgets are sized for ArduinoJson 7.3+");
+static_assert(ARDUINOJSON_POOL_CAPACITY * (sizeof(void*) == 8 ? 16 : 8) == JSON_VARIANT_POOL_BYTES,
+              "ARDUINOJSON_POOL_CAPACITY does not match JSON_VARIANT_POOL_BYTES");
+
+// ArduinoJson v7 allocator backed by an Arena, so JsonDocuments never touch
+// the heap. Documents must be destroyed before the arena is rewound past
+// them (declare the ArenaScope first).
+class JsonArenaAllocator : public ArduinoJson::Allocator {
+public:
+    explicit JsonArenaAllocator(Arena& arena) : _arena(arena) {}
+
+    void* allocate(size_t size) override { return _arena.alloc(size); }
+    void deallocate(void* ptr) override { _arena.free(ptr); }
+    void* reallocate(void* ptr, size_t newSize) override { return _arena.realloc(ptr, newSize); }
+
+private:
+    Arena& _arena;
+};
+
+// Inbound hook messages keep only these fields, whatever else the server
+// forwards (tool inputs can be large). The filter document lives for the
+// whole session; JSON_FILTER_POOL_BYTES is its budget.
+inline void buildHookFilter(JsonDocument& filter) {
+    filter["type"] = true;
+    filter["id"] = true;
+    filter["hook_event_name"] = true;
+}
+
+// One filtered inbound message; NoMemory if it outgrows the arena
+// (JSON_DOC_POOL_BYTES). Shared with the host soak test.
+inline DeserializationError parseHookMessage(JsonDocument& doc, const char* payload, size_t len, JsonDocument& filter) {
+    return deserializeJson(doc, payload, len, DeserializationOption::Filter(filter));
+}
@@ -0,0 +1,147 @@
+#include "Log.h"
+#include <stdio.h>
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+Logger Log;
+
+uint32_t Logger::nowUs() {
+#ifdef ARDUINO
+    return micros();
+#else
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void Logger::put(LogRecord& r, const char* s) {
+    uint8_t i = r.argc++;
+    r.type[i] = LogRecord::ARG_STR;
+    r.size[i] = 0;
+    r.arg[i].textOffset = r.textLen;
+    if (!s) s = "(null)";
+    size_t room = LOG_TEXT_BYTES - r.textLen;   // >= 1, always keeps a terminator
+    size_t n = strnlen(s, room - 1);
+    memcpy(r.text + r.textLen, s, n);
+    r.text[r.textLen + n] = '\0';
+    r.textLen = (uint8_t)(r.textLen + n + (room > n + 1 ? 1 : 0));
+}
+
+// Integer arguments as printf would see them after default promotion:
+// types narrower than int widen to int, then the conversion reinterprets
+// the value at its own width.
+static int64_t asSigned(const LogRecord& r, int i) {
+    switch (r.type[i]) {
+    case LogRecord::ARG_DOUBLE: return (int64_t)r.arg[i].d;
+    case LogRecord::ARG_INT:    return r.arg[i].i;
+    default: break;
+    }
+    int bits = r.size[i] * 8;
+    if (bits < 32 || bits >= 64) return (int64_t)r.arg[i].u;
+    uint64_t sign = 1ull << (bits - 1);
+    return (int64_t)((r.arg[i].u ^ sign) - sign);
+}
+
+static uint64_t asUnsigned(const LogRecord& r, int i) {
+    switch (r.type[i]) {
+    case LogRecord::ARG_DOUBLE: return (uint64_t)r.arg[i].d;
+    case LogRecord::ARG_UINT:   return r.arg[i].u;
+    default: break;
+    }
+    int bits = r.size[i] * 8;
+    if (bits < 32) bits = 32;
+    if (bits >= 64) return r.arg[i].u;
+    return r.arg[i].u & ((1ull << bits) - 1);
+}
+
+static double asDouble(const LogRecord& r, int i) {
+    switch (r.type[i]) {
+    case LogRecord::ARG_DOUBLE: return r.arg[i].d;
+    case LogRecord::ARG_INT:    return (double)r.arg[i].i;
+    case LogRecord::ARG_UINT:   return (double)r.arg[i].u;
+    default:                    return 0.0;
+    }
+}
+
+size_t Logger::format(const LogRecord& r, char* out, size_t cap) {
+    if (!cap) return 0;
+    size_t len = 0;
+    auto room = [&]() { return cap - len; };
+    auto advance = [&](int n) {
+        if (n < 0) return;
+        len += (size_t)n < room() ? (size_t)n : room() - 1;
+    };
+
+    uint32_t ms = r.tsUs / 1000;
+    advance(snprintf(out, cap, "[%lu.%03lu] ", (unsigned long)(ms / 1000), (unsigned long)(ms % 1000)));
+
+    // One conversion at a time: copy literal text, then rebuild each
+    // conversion spec with a length modifier that matches the stored value.
+    int argi = 0;
+    for (const char* p = r.fmt; *p && room() > 1;) {
+        if (*p != '%') {
+            out[len++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[len++] = '%';
+            p += 2;
+            continue;
+        }
+
+        char spec[24];
+        size_t sl = 0;
+        spec[sl++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && sl < sizeof(spec) - 4) spec[sl++] = *p++;
+        while (*p && strchr("hlzjtLq", *p)) p++;   // original length modifier
+        char conv = *p;
+        if (!conv) break;
+        p++;
+
+        if (argi >= r.argc) {
+            advance(snprintf(out + len, room(), "<?>"));
+            continue;
+        }
+        int i = argi++;
+        switch (conv) {
+        case 'd': case 'i':
+            spec[sl++] = 'l'; spec[sl++] = 'l'; spec[sl++] = conv; spec[sl] = '\0';
+            advance(snprintf(out + len, room(), spec, (long long)asSigned(r, i)));
+            break;
+        case 'u': case 'x': case 'X': case 'o':
+            spec[sl++] = 'l'; spec[sl++] = 'l'; spec[sl++] = conv; spec[sl] = '\0';
+            advance(snprintf(out + len, room(), spec, (unsigned long long)asUnsigned(r, i)));
+            break;
+        case 'c':
+            spec[sl++] = conv; spec[sl] = '\0';
+            advance(snprintf(out + len, room(), spec, (int)asSigned(r, i)));
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec[sl++] = conv; spec[sl] = '\0';
+            advance(snprintf(out + len, room(), spec, asDouble(r, i)));
+            break;
+        case 's':
+            spec[sl++] = conv; spec[sl] = '\0';
+            advance(snprintf(out + len, room(), spec,
+                             r.type[i] == LogRecord::ARG_STR ? r.text + r.arg[i].textOffset : "<?>"));
+            break;
+        case 'p':
+            spec[sl++] = conv; spec[sl] = '\0';
+            advance(snprintf(out + len, room(), spec, r.type[i] == LogRecord::ARG_PTR ? r.arg[i].p : nullptr));
+            break;
+        default:
+            advance(snprintf(out + len, room(), "<?>"));
+            break;
+        }
+    }
+
+    if (len == 0 || out[len - 1] != '\n') {
+        if (room() <= 1) len--;   // keep the newline even when truncated
+        out[len++] = '\n';
+    }
+    out[len] = '\0';
+    return len;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "Config.h"
+#include "MpscQueue.h"
+
+// Deferred binary logger.
+//
+// A log call stores the format string pointer (string literals live for
+// the whole program, so the pointer is the message ID), a timestamp and
+// the raw arguments in a lock-free ring; %s arguments are copied (and
+// truncated to LOG_TEXT_BYTES in total). Formatting happens later, when
+// drain() runs on the low-priority log task. A full ring drops the record.
+//
+// Use the LOG_E/W/I/D macros: levels above LOG_LEVEL are removed at
+// compile time. Not for ISRs (use a dedicated SPSC queue there).
+struct LogRecord {
+    enum ArgType : uint8_t { ARG_INT, ARG_UINT, ARG_DOUBLE, ARG_STR, ARG_PTR };
+
+    const char* fmt;
+    uint32_t tsUs;
+    uint8_t level;
+    uint8_t argc;
+    uint8_t textLen;
+    uint8_t type[LOG_MAX_ARGS];
+    uint8_t size[LOG_MAX_ARGS];   // sizeof the original integer argument
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        uint32_t textOffset;
+        const void* p;
+    } arg[LOG_MAX_ARGS];
+    char text[LOG_TEXT_BYTES];
+};
+
+class Logger {
+public:
+    template <typename... Args>
+    void write(uint8_t level, const char* fmt, const Args&... args) {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+        uint32_t ticket;
+        LogRecord* r = _ring.reserve(ticket);
+        if (!r) return;
+        r->fmt = fmt;
+        r->tsUs = nowUs();
+        r->level = level;
+        r->argc = 0;
+        r->textLen = 0;
+        int expand[] = {0, (put(*r, args), 0)...};
+        (void)expand;
+        _ring.commit(ticket);
+    }
+
+    // Consumer (log task): formats up to maxRecords lines and hands each to
+    // sink(line, len). Returns records drained.
+    template <typename Sink>
+    size_t drain(Sink&& sink, size_t maxRecords = LOG_RING_LEN) {
+        char line[LOG_LINE_MAX];
+        size_t n = 0;
+        while (n < maxRecords) {
+            LogRecord* r = _ring.front();
+            if (!r) break;
+            size_t len = format(*r, line, sizeof(line));
+            _ring.popFront();
+            sink(line, len);
+            n++;
+        }
+        return n;
+    }
+
+    // "[sss.mmm] message\n", truncated to cap - 1 characters
+    static size_t format(const LogRecord& r, char* out, size_t cap);
+
+    uint32_t dropped() const { return _ring.dropped(); }
+    size_t pending() const { return _ring.size(); }
+
+private:
+    static uint32_t nowUs();
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    put(LogRecord& r, T v) {
+        uint8_t i = r.argc++;
+        if (std::is_signed<T>::value) {
+            r.type[i] = LogRecord::ARG_INT;
+            r.arg[i].i = (int64_t)v;
+        } else {
+            r.type[i] = LogRecord::ARG_UINT;
+            r.arg[i].u = (uint64_t)v;
+        }
+        r.size[i] = sizeof(T);
+    }
+    static void put(LogRecord& r, double v) {
+        uint8_t i = r.argc++;
+        r.type[i] = LogRecord::ARG_DOUBLE;
+        r.size[i] = sizeof(double);
+        r.arg[i].d = v;
+    }
+    static void put(LogRecord& r, float v) { put(r, (double)v); }
+    static void put(LogRecord& r, const char* s);
+    static void put(LogRecord& r, char* s) { put(r, (const char*)s); }
+    static void put(LogRecord& r, const void* p) {
+        uint8_t i = r.argc++;
+        r.type[i] = LogRecord::ARG_PTR;
+        r.size[i] = sizeof(void*);
+        r.arg[i].p = p;
+    }
+    template <size_t K>
+    static void put(LogRecord& r, const char (&s)[K]) { put(r, (const char*)s); }
+    template <size_t K>
+    static void put(LogRecord& r, char (&s)[K]) { put(r, (const char*)s); }
+
+    MpscQueue<LogRecord, LOG_RING_LEN> _ring;
+};
+
+extern Logger Log;
+
+#define LOG_AT(lvl, fmt, ...) Log.write(lvl, fmt, ##__VA_ARGS__)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(fmt, ...) LOG_AT(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_E(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(fmt, ...) LOG_AT(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_W(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(fmt, ...) LOG_AT(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_I(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_D(fmt, ...) do {} while (0)
+#endif
@@ -0,0 +1,30 @@
+#include "LogTask.h"
+
+LogTask LogOut;
+
+void LogTask::begin() {
+    if (_task) return;
+    xTaskCreatePinnedToCore(taskEntry, "log", LOG_TASK_STACK, this, LOG_TASK_PRIORITY, &_task, LOG_TASK_CORE);
+}
+
+void LogTask::taskEntry(void* arg) {
+    (void)arg;
+    uint32_t reportedDrops = 0;
+    for (;;) {
+        size_t n = Log.drain([](const char* line, size_t len) { Serial.write((const uint8_t*)line, len); });
+        uint32_t drops = Log.dropped();
+        if (drops != reportedDrops) {
+            Serial.printf("[log] %lu records dropped\n", (unsigned long)(drops - reportedDrops));
+            reportedDrops = drops;
+        }
+        if (!n) vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+void LogTask::flush(uint32_t timeoutMs) {
+    uint32_t t0 = millis();
+    while (Log.pending() && millis() - t0 < timeoutMs) {
+        delay(5);
+    }
+    Serial.flush();
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Log.h"
+
+// Low-priority task that drains Log and writes the formatted lines to
+// Serial. USB-CDC stalls (host not reading) only hold up this task; callers
+// keep logging into the ring and overflow shows up in dropped().
+class LogTask {
+public:
+    void begin();
+    // Waits (up to timeoutMs) for queued records to be written, e.g. before deep sleep
+    void flush(uint32_t timeoutMs);
+    uint32_t dropped() const { return Log.dropped(); }
+
+private:
+    static void taskEntry(void* arg);
+    TaskHandle_t _task = nullptr;
+};
+
+extern LogTask LogOut;
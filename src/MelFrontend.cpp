@@ -0,0 +1,208 @@
+#include "MelFrontend.h"
+#include <math.h>
+
+// 400 = 4 * 4 * 5 * 5, mixed-radix Stockham FFT
+static constexpr int FFT_FACTORS[] = {4, 4, 5, 5};
+static constexpr int FFT_STAGES = sizeof(FFT_FACTORS) / sizeof(FFT_FACTORS[0]);
+static_assert(FFT_FACTORS[0] * FFT_FACTORS[1] * FFT_FACTORS[2] * FFT_FACTORS[3] == MEL_N_FFT,
+              "FFT factors must multiply to MEL_N_FFT");
+
+static constexpr double PI_D = 3.14159265358979323846;
+static constexpr int HALF_WIN = MEL_N_FFT / 2;
+
+// Slaney mel scale (librosa htk=False)
+static double hzToMel(double hz) {
+    const double fSp = 200.0 / 3.0;
+    const double minLogHz = 1000.0;
+    const double minLogMel = minLogHz / fSp;
+    const double logStep = log(6.4) / 27.0;
+    if (hz < minLogHz) return hz / fSp;
+    return minLogMel + log(hz / minLogHz) / logStep;
+}
+
+static double melToHz(double mel) {
+    const double fSp = 200.0 / 3.0;
+    const double minLogHz = 1000.0;
+    const double minLogMel = minLogHz / fSp;
+    const double logStep = log(6.4) / 27.0;
+    if (mel < minLogMel) return mel * fSp;
+    return minLogHz * exp(logStep * (mel - minLogMel));
+}
+
+LogMelExtractor::LogMelExtractor() {
+    // Periodic Hann (torch.hann_window default)
+    for (int i = 0; i < MEL_N_FFT; i++) {
+        _window[i] = (float)(0.5 - 0.5 * cos(2.0 * PI_D * i / MEL_N_FFT));
+    }
+    for (int k = 0; k < MEL_N_FFT; k++) {
+        double a = -2.0 * PI_D * k / MEL_N_FFT;
+        _twiddle[k] = {(float)cos(a), (float)sin(a)};
+    }
+    buildFilterbank();
+    reset();
+}
+
+void LogMelExtractor::buildFilterbank() {
+    // librosa.filters.mel(sr=16000, n_fft=400, n_mels=80, norm="slaney")
+    double melF[MEL_BINS + 2];
+    double melMin = hzToMel(0.0);
+    double melMax = hzToMel(SAMPLE_RATE / 2.0);
+    for (int i = 0; i < MEL_BINS + 2; i++) {
+        melF[i] = melToHz(melMin + (melMax - melMin) * i / (MEL_BINS + 1));
+    }
+
+    uint16_t offset = 0;
+    for (int m = 0; m < MEL_BINS; m++) {
+        double lo = melF[m], mid = melF[m + 1], hi = melF[m + 2];
+        double enorm = 2.0 / (hi - lo);
+        _fStart[m] = 0;
+        _fLen[m] = 0;
+        _fOffset[m] = offset;
+        for (int b = 0; b < MEL_FFT_BINS; b++) {
+            double f = (double)b * SAMPLE_RATE / MEL_N_FFT;
+            double lower = (f - lo) / (mid - lo);
+            double upper = (hi - f) / (hi - mid);
+            double w = fmax(0.0, fmin(lower, upper));
+            if (w <= 0.0) {
+                if (_fLen[m]) break;   // past the triangle
+                continue;
+            }
+            if (!_fLen[m]) _fStart[m] = (uint16_t)b;
+            if (offset >= FILTER_WEIGHTS_MAX) break;
+            _fWeights[offset++] = (float)(w * enorm);
+            _fLen[m]++;
+        }
+    }
+}
+
+float LogMelExtractor::filterWeight(int mel, int bin) const {
+    if (mel < 0 || mel >= MEL_BINS) return 0.0f;
+    int i = bin - _fStart[mel];
+    if (i < 0 || i >= _fLen[mel]) return 0.0f;
+    return _fWeights[_fOffset[mel] + i];
+}
+
+void LogMelExtractor::reset() {
+    _total = 0;
+    _nextFrame = 0;
+}
+
+float LogMelExtractor::sampleAt(int32_t idx, bool flushing) const {
+    // Centre framing with reflect padding at both ends (torch.stft center=True)
+    if (idx < 0) idx = -idx;
+    if (flushing && idx >= _total) idx = 2 * (_total - 1) - idx;
+    if (idx < 0) idx = 0;                      // utterance shorter than half a window
+    if (idx >= _total) idx = _total - 1;
+    return _ring[idx & (RING - 1)] * (1.0f / 32768.0f);
+}
+
+void LogMelExtractor::emitFrame(int32_t t, bool flushing, float* melOut) {
+    int32_t start = t * MEL_HOP - HALF_WIN;
+    for (int i = 0; i < MEL_N_FFT; i++) {
+        _frame[i] = sampleAt(start + i, flushing);
+    }
+    computeFrame(_frame, melOut);
+}
+
+size_t LogMelExtractor::push(const int16_t* pcm, size_t n, float* out) {
+    size_t frames = 0;
+    for (size_t i = 0; i < n; i++) {
+        _ring[_total & (RING - 1)] = pcm[i];
+        _total++;
+
+        // Frame t is ready once its last sample (or, for t == 0, the
+        // deepest reflected sample HALF_WIN) has arrived.
+        for (;;) {
+            int32_t centre = _nextFrame * MEL_HOP;
+            int32_t need = centre + HALF_WIN - 1;
+            if (HALF_WIN - centre > need) need = HALF_WIN - centre;
+            if (need >= _total) break;
+            emitFrame(_nextFrame++, false, out + frames * MEL_BINS);
+            frames++;
+        }
+    }
+    return frames;
+}
+
+size_t LogMelExtractor::flush(float* out) {
+    size_t frames = 0;
+    int32_t last = _total / MEL_HOP;   // exclusive, like whisper's stft[..., :-1]
+    while (_nextFrame < last && frames < FLUSH_FRAMES_MAX) {
+        emitFrame(_nextFrame++, true, out + frames * MEL_BINS);
+        frames++;
+    }
+    return frames;
+}
+
+void LogMelExtractor::fftInPlace() {
+    // Stockham autosort, decimation in frequency: natural order in and out,
+    // ping-ponging between _bufA and _bufB.
+    Complex* in = _bufA;
+    Complex* out = _bufB;
+    int n = MEL_N_FFT;
+    int s = 1;
+    for (int stage = 0; stage < FFT_STAGES; stage++) {
+        const int r = FFT_FACTORS[stage];
+        const int m = n / r;
+        const int twStep = MEL_N_FFT / n;      // W_n = W_N^(N/n)
+        const int rootStep = MEL_N_FFT / r;    // W_r = W_N^(N/r)
+        for (int p = 0; p < m; p++) {
+            for (int q = 0; q < s; q++) {
+                Complex a[MAX_RADIX];
+                for (int k = 0; k < r; k++) a[k] = in[q + s * (p + k * m)];
+                for (int j = 0; j < r; j++) {
+                    float accRe = 0.0f, accIm = 0.0f;
+                    for (int k = 0; k < r; k++) {
+                        const Complex& w = _twiddle[(j * k * rootStep) % MEL_N_FFT];
+                        accRe += a[k].re * w.re - a[k].im * w.im;
+                        accIm += a[k].re * w.im + a[k].im * w.re;
+                    }
+                    const Complex& w = _twiddle[(p * j * twStep) % MEL_N_FFT];
+                    Complex& y = out[q + s * (r * p + j)];
+                    y.re = accRe * w.re - accIm * w.im;
+                    y.im = accRe * w.im + accIm * w.re;
+                }
+            }
+        }
+        Complex* tmp = in;
+        in = out;
+        out = tmp;
+        n = m;
+        s *= r;
+    }
+    if (in != _bufA) {
+        for (int i = 0; i < MEL_N_FFT; i++) _bufA[i] = in[i];
+    }
+}
+
+void LogMelExtractor::fft(const float* re, float* outRe, float* outIm) {
+    for (int i = 0; i < MEL_N_FFT; i++) _bufA[i] = {re[i], 0.0f};
+    fftInPlace();
+    for (int i = 0; i < MEL_N_FFT; i++) {
+        outRe[i] = _bufA[i].re;
+        outIm[i] = _bufA[i].im;
+    }
+}
+
+void LogMelExtractor::computeFrame(const float* samples, float* melOut) {
+    for (int i = 0; i < MEL_N_FFT; i++) _bufA[i] = {samples[i] * _window[i], 0.0f};
+    fftInPlace();
+    for (int b = 0; b < MEL_FFT_BINS; b++) {
+        _power[b] = _bufA[b].re * _bufA[b].re + _bufA[b].im * _bufA[b].im;
+    }
+    for (int m = 0; m < MEL_BINS; m++) {
+        const float* w = &_fWeights[_fOffset[m]];
+        const float* p = &_power[_fStart[m]];
+        float acc = 0.0f;
+        for (int i = 0; i < _fLen[m]; i++) acc += w[i] * p[i];
+        melOut[m] = log10f(acc > 1e-10f ? acc : 1e-10f);
+    }
+}
+
+void LogMelExtractor::quantize(const float* logMel, int16_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        float v = logMel[i] * MEL_Q_SCALE;
+        v = v < -32768.0f ? -32768.0f : (v > 32767.0f ? 32767.0f : v);
+        out[i] = (int16_t)lrintf(v);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Config.h"
+
+// Streaming whisper-style log-mel front end.
+//
+// Matches whisper's log_mel_spectrogram() up to (not including) its
+// per-utterance normalisation: 400-point STFT with a periodic Hann window,
+// hop 160, centre framing with reflect padding, |X|^2, 80 Slaney mel
+// filters (librosa defaults), log10(max(mel, 1e-10)). Frame t is centred on
+// sample t * MEL_HOP; an utterance of N samples yields N / MEL_HOP frames
+// (whisper drops the last STFT frame).
+//
+// Float throughout: the ESP32-S3 has a single-precision FPU.
+class LogMelExtractor {
+public:
+    LogMelExtractor();
+
+    // Start of a new utterance
+    void reset();
+
+    // Feeds PCM and writes every frame that became computable
+    // (MEL_BINS floats each). `out` must hold maxFramesFor(n) frames.
+    size_t push(const int16_t* pcm, size_t n, float* out);
+    // End of utterance: writes the remaining (end-reflected) frames.
+    // `out` must hold FLUSH_FRAMES_MAX frames.
+    size_t flush(float* out);
+
+    static constexpr size_t maxFramesFor(size_t n) { return n / MEL_HOP + 1; }
+    static constexpr size_t FLUSH_FRAMES_MAX = (MEL_N_FFT / 2) / MEL_HOP + 1;
+
+    // One frame from MEL_N_FFT samples in [-1, 1) (window applied inside).
+    void computeFrame(const float* samples, float* melOut);
+
+    // Upload encoding, see MEL_Q_SCALE
+    static void quantize(const float* logMel, int16_t* out, size_t n);
+
+    // Exposed for tests
+    void fft(const float* re, float* outRe, float* outIm);
+    float filterWeight(int mel, int bin) const;
+
+private:
+    struct Complex { float re, im; };
+
+    static constexpr int RING = 512;       // > window + hop, power of two
+    static constexpr int MAX_RADIX = 5;
+    static constexpr int FILTER_WEIGHTS_MAX = MEL_FFT_BINS * 2;  // each bin feeds <= 2 filters
+
+    void buildFilterbank();
+    float sampleAt(int32_t idx, bool flushing) const;
+    void emitFrame(int32_t t, bool flushing, float* melOut);
+    void fftInPlace();
+
+    float _window[MEL_N_FFT];
+    Complex _twiddle[MEL_N_FFT];     // W_N^k = exp(-2 pi i k / N)
+    Complex _bufA[MEL_N_FFT];
+    Complex _bufB[MEL_N_FFT];
+    float _frame[MEL_N_FFT];
+    float _power[MEL_FFT_BINS];
+
+    // Sparse filterbank: filter m covers bins [_fStart[m], _fStart[m] + _fLen[m])
+    // with weights at _fWeights[_fOffset[m]...]
+    uint16_t _fStart[MEL_BINS];
+    uint16_t _fLen[MEL_BINS];
+    uint16_t _fOffset[MEL_BINS];
+    float _fWeights[FILTER_WEIGHTS_MAX];
+
+    int16_t _ring[RING];
+    int32_t _total = 0;      // samples received this utterance
+    int32_t _nextFrame = 0;  // next frame index to emit
+};
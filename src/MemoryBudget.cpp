@@ -0,0 +1,21 @@
+#include "MemoryBudget.h"
+#include "AudioSource.h"
+#include "ButtonEvents.h"
+#include "DmaRing.h"
+#include "Log.h"
+#include "MelFrontend.h"
+#include "NetLink.h"
+#include "Protocol.h"
+#include "UploadFramer.h"
+
+// Compile-time only: each line item in MemoryBudget.h must cover the real object.
+static_assert(sizeof(NetLink) <= MEM_NET_LINK_BYTES, "NetLink outgrew MEM_NET_LINK_BYTES");
+static_assert(sizeof(Logger) <= MEM_LOG_RING_BYTES, "Logger outgrew MEM_LOG_RING_BYTES");
+static_assert(sizeof(ButtonEventQueue) <= MEM_BUTTON_QUEUE_BYTES, "ButtonEventQueue outgrew MEM_BUTTON_QUEUE_BYTES");
+static_assert(sizeof(DmaRing) + CHUNK_BYTES + (AUDIO_SOURCE_SYNTH ? sizeof(SynthSource) : 0) <= MEM_CAPTURE_BYTES,
+              "capture buffers outgrew MEM_CAPTURE_BYTES");
+static_assert(sizeof(RecentIds) <= MEM_HOOK_IDS_BYTES, "RecentIds outgrew MEM_HOOK_IDS_BYTES");
+static_assert(sizeof(UploadFramer) <= MEM_UPLOAD_BYTES, "UploadFramer outgrew MEM_UPLOAD_BYTES");
+static_assert(!UPLOAD_LOGMEL || sizeof(LogMelExtractor) <= MEM_LOGMEL_BYTES, "LogMelExtractor outgrew MEM_LOGMEL_BYTES");
+static_assert(sizeof(StaticArena<MEM_NET_ARENA_BYTES>) <= MEM_NET_ARENA_BYTES + sizeof(Arena) + Arena::ALIGN,
+              "arena storage is not MEM_NET_ARENA_BYTES");
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stddef.h>
+#include "Config.h"
+#include "Arena.h"
+
+// Compile-time RAM budget for the firmware's own runtime buffers.
+//
+// Every per-session and per-message buffer is static and sized here from
+// Config.h; nothing on the record / hook path allocates from the heap.
+// Line items for the fixed queues are upper bounds checked against the real
+// sizeof in MemoryBudget.cpp, so the total below cannot silently drift.
+// Library internals (WiFi, WebSockets, M5Unified, IDF I2S DMA) are not
+// covered; the heap report in the Metrics block watches those.
+
+// ---- Network task, per message: JSON arena ----
+// Filter document (built once, lives at the bottom of the arena), then one
+// inbound parse or one outbound message at a time on top of it.
+static constexpr size_t MEM_JSON_OUT_BYTES = Arena::blockBytes(JSON_OUT_MAX_LEN);
+static constexpr size_t MEM_NET_ARENA_BYTES = JSON_FILTER_POOL_BYTES + JSON_DOC_POOL_BYTES + MEM_JSON_OUT_BYTES;
+
+// ---- Per session ----
+static constexpr size_t MEM_HOOK_IDS_BYTES = (size_t)HOOK_ID_DEDUP * HOOK_ID_MAX_LEN + 8;
+// UploadFramer: request id and one chunk's feature output (PCM uploads too)
+static constexpr size_t MEM_UPLOAD_BYTES = REQ_ID_MAX_LEN + MEL_FRAMES_PER_CHUNK_MAX * MEL_BINS * (sizeof(float) + sizeof(int16_t))
+                                         + 64;
+
+// ---- Fixed queues and rings ----
+static constexpr size_t MEM_NET_LINK_BYTES = NET_AUDIO_QUEUE_LEN * (CHUNK_BYTES + 8)
+                                           + NET_CMD_QUEUE_LEN * (REQ_ID_MAX_LEN + 16)
+                                           + NET_HOOK_QUEUE_LEN * (HOOK_NAME_MAX_LEN + 4) + 256;
+static constexpr size_t MEM_LOG_RING_BYTES = LOG_RING_LEN * (LOG_TEXT_BYTES + LOG_MAX_ARGS * 10 + 32) + 64;
+static constexpr size_t MEM_BUTTON_QUEUE_BYTES = BUTTON_EDGE_QUEUE_LEN * 8 + 8 * 16 + 64;
+// M5.Mic copy buffer, DMA hand-off ring (or the IDF 4.4 read buffer), synthetic source
+static constexpr size_t MEM_CAPTURE_BYTES = CHUNK_BYTES + I2S_DMA_READY_QUEUE_LEN * 2 * sizeof(void*) + 64
+                                          + (CAPTURE_I2S_DMA ? CHUNK_BYTES : 0)
+                                          + (AUDIO_SOURCE_SYNTH ? CHUNK_BYTES + 128 : 0);
+
+// ---- Optional log-mel front end ----
+static constexpr size_t MEM_LOGMEL_BYTES = UPLOAD_LOGMEL
+    ? MEL_N_FFT * 8 * sizeof(float) + MEL_FFT_BINS * 3 * sizeof(float) + MEL_BINS * 6 + 512 * 2 + 64
+    : 0;
+
+static constexpr size_t MEM_TOTAL_BYTES = MEM_NET_ARENA_BYTES + MEM_HOOK_IDS_BYTES + MEM_UPLOAD_BYTES
+                                        + MEM_NET_LINK_BYTES + MEM_LOG_RING_BYTES + MEM_BUTTON_QUEUE_BYTES
+                                        + MEM_CAPTURE_BYTES + MEM_LOGMEL_BYTES;
+static_assert(MEM_TOTAL_BYTES <= APP_RAM_BUDGET_BYTES, "static buffers exceed APP_RAM_BUDGET_BYTES (Config.h)");
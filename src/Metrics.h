@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+// Running latency statistics in microseconds (last / max / average).
+struct LatencyStat {
+    uint32_t count = 0;
+    uint32_t lastUs = 0;
+    uint32_t maxUs = 0;
+    uint64_t totalUs = 0;
+
+    void record(uint32_t us) {
+        count++;
+        lastUs = us;
+        totalUs += us;
+        if (us > maxUs) maxUs = us;
+    }
+
+    uint32_t avgUs() const { return count ? (uint32_t)(totalUs / count) : 0; }
+
+    void reset() { *this = LatencyStat(); }
+};
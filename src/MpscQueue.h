@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bounded lock-free multi-producer / single-consumer ring (Vyukov's
+// per-cell sequence scheme).
+//
+// Producers on any task or core claim a cell with one CAS, fill it in
+// place and publish it; a full ring rejects the claim and counts it in
+// dropped(). Nothing ever blocks. A producer preempted between reserve()
+// and commit() only delays the consumer at that cell.
+template <typename T, size_t N>
+class MpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscQueue capacity must be a power of two");
+
+public:
+    MpscQueue() {
+        for (uint32_t i = 0; i < N; i++) _cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // Producer side, zero-copy: fill the returned item, then commit(ticket).
+    // Returns nullptr (and counts a drop) when full.
+    T* reserve(uint32_t& ticket) {
+        uint32_t pos = _enqueue.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = _cells[pos & (N - 1)];
+            int32_t dif = (int32_t)(c.seq.load(std::memory_order_acquire) - pos);
+            if (dif == 0) {
+                if (_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    ticket = pos;
+                    return &c.data;
+                }
+            } else if (dif < 0) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            } else {
+                pos = _enqueue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    void commit(uint32_t ticket) {
+        _cells[ticket & (N - 1)].seq.store(ticket + 1, std::memory_order_release);
+    }
+
+    // Consumer side, zero-copy: inspect front(), then popFront().
+    T* front() {
+        uint32_t pos = _dequeue.load(std::memory_order_relaxed);
+        Cell& c = _cells[pos & (N - 1)];
+        if (c.seq.load(std::memory_order_acquire) != pos + 1) return nullptr;
+        return &c.data;
+    }
+    void popFront() {
+        uint32_t pos = _dequeue.load(std::memory_order_relaxed);
+        _cells[pos & (N - 1)].seq.store(pos + N, std::memory_order_release);
+        _dequeue.store(pos + 1, std::memory_order_release);
+    }
+
+    // Either side (approximate; includes claimed but uncommitted cells)
+    size_t size() const {
+        return _enqueue.load(std::memory_order_acquire) - _dequeue.load(std::memory_order_acquire);
+    }
+    static constexpr size_t capacity() { return N; }
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        T data;
+    };
+
+    Cell _cells[N];
+    std::atomic<uint32_t> _enqueue{0};
+    std::atomic<uint32_t> _dequeue{0};     // written by consumer only
+    std::atomic<uint32_t> _dropped{0};
+};
@@ -0,0 +1,49 @@
+#include "NetLink.h"
+#include <string.h>
+
+static void copyStr(char* dst, size_t cap, const char* src) {
+    if (!src) src = "";
+    size_t n = strlen(src);
+    if (n >= cap) n = cap - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+bool NetLink::postAudio(const uint8_t* data, size_t len, uint32_t nowUs) {
+    if (len > sizeof(AudioFrame::data)) return false;
+    AudioFrame* f = _audio.reserve();
+    if (!f) return false;   // counted in audioQueue().dropped()
+    f->enqUs = nowUs;
+    f->len = (uint16_t)len;
+    memcpy(f->data, data, len);
+    _audio.commit();
+    _framesPosted++;
+    return true;
+}
+
+bool NetLink::postCommand(NetCommandType type, const char* reqId, uint32_t nowUs, uint32_t pressUs) {
+    NetCommand* c = _commands.reserve();
+    if (!c) return false;
+    c->enqUs = nowUs;
+    c->pressUs = pressUs;
+    c->afterFrame = _framesPosted;
+    c->type = type;
+    copyStr(c->reqId, sizeof(c->reqId), reqId);
+    _commands.commit();
+    return true;
+}
+
+bool NetLink::postHook(const char* name, uint32_t nowUs) {
+    HookEvent* h = _hooks.reserve();
+    if (!h) return false;
+    h->enqUs = nowUs;
+    copyStr(h->name, sizeof(h->name), name);
+    _hooks.commit();
+    return true;
+}
+
+bool NetLink::pollHook(HookEvent& out, uint32_t nowUs) {
+    if (!_hooks.pop(out)) return false;
+    _hookLatency.record(nowUs - out.enqUs);
+    return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Config.h"
+#include "Metrics.h"
+#include "SpscQueue.h"
+
+// Cross-core link between the Arduino loop (main side) and the network task.
+// Three bounded lock-free SPSC queues, no shared locks:
+//   main -> net: audio frames, control commands
+//   net -> main: hook events
+// Every item carries its enqueue time so the consumer can record cross-core
+// latency. Commands remember how many audio frames were posted before them,
+// so start / audio / end leave the network task in the order they were posted.
+
+enum NetCommandType : uint8_t {
+    NET_CMD_START,
+    NET_CMD_END,
+    NET_CMD_APPROVE,
+    NET_CMD_REJECT,
+    NET_CMD_BACKSPACE,
+    NET_CMD_TOGGLE_AUTO_APPROVE,
+    NET_CMD_PREPARE_SLEEP,
+};
+
+struct NetCommand {
+    uint32_t enqUs;
+    uint32_t pressUs;      // button press that caused it, 0 = none (press-to-send)
+    uint32_t afterFrame;   // send once this many audio frames have gone out
+    NetCommandType type;
+    char reqId[REQ_ID_MAX_LEN];
+};
+
+struct AudioFrame {
+    uint32_t enqUs;
+    uint16_t len;
+    uint8_t data[CHUNK_BYTES];
+};
+
+struct HookEvent {
+    uint32_t enqUs;
+    char name[HOOK_NAME_MAX_LEN];
+};
+
+class NetLink {
+public:
+    // ---- Main side ----
+    bool postAudio(const uint8_t* data, size_t len, uint32_t nowUs);
+    bool postCommand(NetCommandType type, const char* reqId, uint32_t nowUs, uint32_t pressUs = 0);
+    // Pops one hook event and records its net -> main latency.
+    bool pollHook(HookEvent& out, uint32_t nowUs);
+
+    // ---- Network side ----
+    bool postHook(const char* name, uint32_t nowUs);
+
+    // Hands up to `max` outbound items to sink.onCommand() / sink.onAudio(),
+    // in posting order. `now` returns microseconds on the shared clock.
+    template <typename Sink, typename Now>
+    size_t drain(Sink& sink, Now now, size_t max) {
+        size_t n = 0;
+        while (n < max) {
+            // Audio first: a command committed before this frame is then
+            // guaranteed visible below, so it cannot be overtaken.
+            AudioFrame* f = _audio.front();
+            NetCommand* cmd = _commands.front();
+            if (cmd && (int32_t)(_framesSent - cmd->afterFrame) >= 0) {
+                _commandLatency.record(now() - cmd->enqUs);
+                sink.onCommand(*cmd);
+                _commands.popFront();
+            } else if (f) {
+                _audioLatency.record(now() - f->enqUs);
+                sink.onAudio(*f);
+                _audio.popFront();
+                _framesSent++;
+            } else {
+                break;
+            }
+            n++;
+        }
+        return n;
+    }
+
+    // ---- Metrics (each stat is written by its consumer side only) ----
+    const SpscQueue<AudioFrame, NET_AUDIO_QUEUE_LEN>& audioQueue() const { return _audio; }
+    const SpscQueue<NetCommand, NET_CMD_QUEUE_LEN>& commandQueue() const { return _commands; }
+    const SpscQueue<HookEvent, NET_HOOK_QUEUE_LEN>& hookQueue() const { return _hooks; }
+    const LatencyStat& audioLatency() const { return _audioLatency; }      // main -> net
+    const LatencyStat& commandLatency() const { return _commandLatency; }  // main -> net
+    const LatencyStat& hookLatency() const { return _hookLatency; }        // net -> main
+
+private:
+    SpscQueue<AudioFrame, NET_AUDIO_QUEUE_LEN> _audio;
+    SpscQueue<NetCommand, NET_CMD_QUEUE_LEN> _commands;
+    SpscQueue<HookEvent, NET_HOOK_QUEUE_LEN> _hooks;
+
+    uint32_t _framesPosted = 0;   // main side only
+    uint32_t _framesSent = 0;     // network side only
+
+    LatencyStat _audioLatency;
+    LatencyStat _commandLatency;
+    LatencyStat _hookLatency;
+};
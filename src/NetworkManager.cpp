@@ -1,33 +1,214 @@
 #include "NetworkManager.h"
+#include "Log.h"
+#include <esp_wifi.h>
 
 AppNetworkManager NetworkMgr;
 
-void AppNetworkManager::begin() {
+// Survives deep sleep (RTC slow memory): lets a resume skip the AP scan and mDNS.
+struct ResumeCache {
+    uint32_t magic;
+    uint8_t netIndex;     // index into WIFI_NETWORKS
+    uint8_t bssid[6];
+    int32_t channel;
+    uint32_t serverIp;    // 0 = unknown
+};
+static constexpr uint32_t RESUME_MAGIC = 0x52534D31;  // "RSM1"
+RTC_DATA_ATTR static ResumeCache resumeCache;
+
+static bool resumeCacheValid() {
+    return resumeCache.magic == RESUME_MAGIC && resumeCache.netIndex < WIFI_NETWORKS.size();
+}
+
+void AppNetworkManager::begin(bool fastResume) {
+    _fastResume = fastResume && resumeCacheValid();
+    xTaskCreatePinnedToCore(taskEntry, "net", NET_TASK_STACK, this, NET_TASK_PRIORITY, nullptr, NET_TASK_CORE);
+}
+
+void AppNetworkManager::taskEntry(void* arg) {
+    static_cast<AppNetworkManager*>(arg)->taskLoop();
+}
+
+void AppNetworkManager::taskLoop() {
     // Setup WiFi Multi
     for (const auto& cred : WIFI_NETWORKS) {
         _wifiMulti.addAP(cred.ssid, cred.password);
     }
 
-    Serial.println("Connecting to WiFi...");
+    buildHookFilter(_hookFilter);
+
+    LOG_I("Connecting to WiFi...");
+    _roam.begin(millis());
     connectWiFi();
     
     // Initial connection attempt
     resolveAndConnect();
+
+    // NetLink sink; nested so it can reach the private senders
+    struct Sink {
+        AppNetworkManager* self;
+        void onCommand(const NetCommand& c) { self->onCommand(c); }
+        void onAudio(const AudioFrame& f) { self->onAudio(f); }
+    } sink{this};
+
+    for (;;) {
+        if (_metricsRequested.load(std::memory_order_acquire)) {
+            postMetrics();
+            _metricsRequested.store(false, std::memory_order_release);
+        }
+        if (!_radioOff) service();
+        if (_link.drain(sink, micros, NET_AUDIO_QUEUE_LEN) == 0) {
+            vTaskDelay(1);
+        }
+    }
+}
+
+void AppNetworkManager::loop() {
+    HookEvent ev;
+    while (_link.pollHook(ev, micros())) {
+        if (_hookCallback) {
+            _hookCallback(ev.name);
+        }
+    }
+    NetMetrics m;
+    if (_metrics.pop(m)) logNetMetrics(m);
+}
+
+void AppNetworkManager::onCommand(const NetCommand& cmd) {
+    switch (cmd.type) {
+    case NET_CMD_START:
+        _uploading = true;
+        _uploadBytes = 0;
+        _uploadStartUs = _uploadLastUs = micros();
+        sendStartMessage(cmd.reqId);
+        break;
+    case NET_CMD_END:
+        sendEndMessage(cmd.reqId);
+        _uploading = false;
+        _roam.noteUpload(_uploadBytes, _uploadLastUs - _uploadStartUs);
+        break;
+    case NET_CMD_APPROVE:             sendCommandMessage("approve", cmd.pressUs); break;
+    case NET_CMD_REJECT:              sendCommandMessage("reject", cmd.pressUs); break;
+    case NET_CMD_BACKSPACE:           sendCommandMessage("backspace", cmd.pressUs); break;
+    case NET_CMD_TOGGLE_AUTO_APPROVE: sendCommandMessage("toggle_auto_approve", cmd.pressUs); break;
+    case NET_CMD_PREPARE_SLEEP:       shutdownRadio(); break;
+    }
+}
+
+void AppNetworkManager::onAudio(const AudioFrame& frame) {
+    if (_wsConnected) {
+        bool ok = _ws.sendBIN(frame.data, frame.len);
+        _uploadLastUs = micros();
+        _uploadBytes += frame.len;
+        _roam.noteTx(ok);
+    }
+}
+
+void AppNetworkManager::postMetrics() {
+    NetMetrics m;
+    m.audioLatency = _link.audioLatency();
+    m.commandLatency = _link.commandLatency();
+    m.pressToSend = _pressToSend;
+    m.arenaUsed = _arena.used();
+    m.arenaCapacity = _arena.capacity();
+    m.arenaHighWater = _arena.highWater();
+    m.arenaAllocs = _arena.allocations();
+    m.arenaFailures = _arena.failures();
+    m.roam = _roam.stats();
+    m.rssiEma = _roam.rssiEma();
+    _metrics.push(m);   // full: the previous snapshot is still unread, drop this one
+}
+
+void AppNetworkManager::logMetrics() {
+    auto q = [](const char* name, size_t depth, uint32_t hw, size_t cap, uint32_t drop) {
+        LOG_I("  %-6s depth %u/%u hw %lu drop %lu", name, depth, cap, hw, drop);
+    };
+    auto l = [](const char* name, const LatencyStat& s) {
+        LOG_I("  %-6s latency n=%lu avg %lu us max %lu us", name, s.count, s.avgUs(), s.maxUs);
+    };
+    // Queue counters are atomics, hook latency is recorded on this side
+    q("audio", _link.audioQueue().size(), _link.audioQueue().highWater(), NET_AUDIO_QUEUE_LEN, _link.audioQueue().dropped());
+    q("cmd", _link.commandQueue().size(), _link.commandQueue().highWater(), NET_CMD_QUEUE_LEN, _link.commandQueue().dropped());
+    q("hook", _link.hookQueue().size(), _link.hookQueue().highWater(), NET_HOOK_QUEUE_LEN, _link.hookQueue().dropped());
+    l("hook", _link.hookLatency());
+
+    // The rest belongs to the network task: it posts a snapshot, loop() logs it
+    _metricsRequested.store(true, std::memory_order_release);
+}
+
+void AppNetworkManager::logNetMetrics(const NetMetrics& m) {
+    auto l = [](const char* name, const LatencyStat& s) {
+        LOG_I("  %-6s latency n=%lu avg %lu us max %lu us", name, s.count, s.avgUs(), s.maxUs);
+    };
+    l("audio", m.audioLatency);
+    l("cmd", m.commandLatency);
+    LOG_I("  button press-to-send n=%lu avg %lu us max %lu us", m.pressToSend.count, m.pressToSend.avgUs(),
+          m.pressToSend.maxUs);
+    LOG_I("  arena  json used %lu/%lu hw %lu, %lu allocs, %lu failed", m.arenaUsed, m.arenaCapacity,
+          m.arenaHighWater, m.arenaAllocs, m.arenaFailures);
+    LOG_I("  roam   n=%lu failed %lu scans %lu, rssi now %d dBm", m.roam.roams, m.roam.failedRoams, m.roam.scans,
+          (int)m.rssiEma);
+    LOG_I("  roam   last %d -> %d dBm, upload %lu -> %lu kbps", m.roam.lastFromRssi, m.roam.lastToRssi,
+          m.roam.lastPreKbps, m.roam.lastPostKbps);
 }
 
 void AppNetworkManager::connectWiFi() {
-    while (_wifiMulti.run() != WL_CONNECTED) {
-        delay(500);
-        Serial.print(".");
+    if (!(_fastResume && connectCachedAP())) {
+        while (_wifiMulti.run() != WL_CONNECTED) {
+            delay(500);
+        }
+    }
+    IPAddress local = WiFi.localIP();
+    LOG_I("WiFi connected, IP: %u.%u.%u.%u", local[0], local[1], local[2], local[3]);
+    _roam.noteConnected(millis(), WiFi.BSSID());
+    // WiFi power save is owned by PowerManager (see PowerPolicy.h)
+}
+
+bool AppNetworkManager::connectCachedAP() {
+    const auto& cred = WIFI_NETWORKS[resumeCache.netIndex];
+    LOG_I("Fast resume: joining %s on channel %ld", cred.ssid, resumeCache.channel);
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(cred.ssid, cred.password, resumeCache.channel, resumeCache.bssid);
+
+    uint32_t start = millis();
+    while (WiFi.status() != WL_CONNECTED) {
+        if (millis() - start > RESUME_WIFI_TIMEOUT_MS) {
+            LOG_W("Fast resume: cached AP not reachable, scanning");
+            WiFi.disconnect();
+            return false;
+        }
+        delay(20);
+    }
+    return true;
+}
+
+void AppNetworkManager::prepareForDeepSleep() {
+    _link.postCommand(NET_CMD_PREPARE_SLEEP, "", micros());
+    uint32_t start = millis();
+    while (!_radioOff && millis() - start < 1000) {
+        delay(10);
+    }
+}
+
+void AppNetworkManager::shutdownRadio() {
+    resumeCache.magic = 0;
+    if (WiFi.status() == WL_CONNECTED) {
+        String ssid = WiFi.SSID();
+        for (size_t i = 0; i < WIFI_NETWORKS.size(); i++) {
+            if (ssid == WIFI_NETWORKS[i].ssid) {
+                resumeCache.netIndex = (uint8_t)i;
+                memcpy(resumeCache.bssid, WiFi.BSSID(), sizeof(resumeCache.bssid));
+                resumeCache.channel = WiFi.channel();
+                resumeCache.serverIp = _ipResolved ? (uint32_t)_serverIP : 0;
+                resumeCache.magic = RESUME_MAGIC;
+                break;
+            }
+        }
     }
-    Serial.println();
-    Serial.print("WiFi connected, IP: ");
-    Serial.println(WiFi.localIP());
 
-    // Maximize power to keep external battery awake
-    // WiFi.setTxPower(WIFI_POWER_19_5dBm);
-    WiFi.setSleep(false);
-    Serial.println("WiFi: Max TX power set, Power Save disabled");
+    _ws.disconnect();
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    _radioOff = true;
 }
 
 String AppNetworkManager::stripLocalSuffix(const char* hostname) {
@@ -43,29 +224,33 @@ void AppNetworkManager::resolveAndConnect() {
 
     // Check if WS_HOST is already an IP address
     if (ip.fromString(WS_HOST)) {
-        Serial.printf("Using direct IP: %s\n", WS_HOST);
+        LOG_I("Using direct IP: %s", WS_HOST);
+    } else if (_fastResume && resumeCache.serverIp) {
+        // Skip mDNS; loop() falls back to a full resolve if this IP is stale
+        ip = IPAddress(resumeCache.serverIp);
+        _ipFromCache = true;
+        LOG_I("Fast resume: cached server IP %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
     } else {
         // Need mDNS resolution for hostname
         if (!MDNS.begin("esp32-client")) {
-            Serial.println("Error setting up MDNS responder!");
+            LOG_E("Error setting up MDNS responder!");
         }
 
         // Strip .local suffix — MDNS.queryHost() expects bare hostname
         String hostBare = stripLocalSuffix(WS_HOST);
-        Serial.printf("Resolving host: %s\n", hostBare.c_str());
+        LOG_I("Resolving host: %s", hostBare.c_str());
 
         // Retry loop: up to 5 attempts with 1s backoff
         for (int attempt = 0; attempt < 5; attempt++) {
             ip = MDNS.queryHost(hostBare.c_str());
             if (ip != IPAddress()) break;
-            Serial.printf("mDNS attempt %d failed, retrying...\n", attempt + 1);
+            LOG_W("mDNS attempt %d failed, retrying...", attempt + 1);
             delay(1000);
         }
     }
 
     if (ip != IPAddress()) {
-        Serial.print("Server IP: ");
-        Serial.println(ip);
+        LOG_I("Server IP: %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
         _serverIP = ip;
         _ipResolved = true;
         _lastResolveTime = millis();
@@ -77,17 +262,25 @@ void AppNetworkManager::resolveAndConnect() {
         });
         _ws.setReconnectInterval(2000);
     } else {
-        Serial.println("mDNS resolution failed after 5 attempts.");
+        LOG_E("mDNS resolution failed after 5 attempts.");
     }
+    _fastResume = false;
 }
 
-void AppNetworkManager::loop() {
+void AppNetworkManager::service() {
     // Ensure WiFi
     if (_wifiMulti.run() != WL_CONNECTED) {
-        Serial.println("WiFi lost, reconnecting...");
+        LOG_W("WiFi lost, reconnecting...");
     }
 
     if (WiFi.status() == WL_CONNECTED) {
+        if (_ipFromCache && !_wsConnected && millis() - _lastResolveTime >= RESUME_WS_TIMEOUT_MS) {
+            LOG_W("Fast resume: cached server IP not answering, re-resolving");
+            _ipFromCache = false;
+            _ipResolved = false;
+            _ws.disconnect();
+        }
+
         if (!_ipResolved) {
             // Initial resolution not yet done — attempt now
             resolveAndConnect();
@@ -95,15 +288,14 @@ void AppNetworkManager::loop() {
             // Periodic re-resolution: re-query mDNS in case server IP changed
             uint32_t now = millis();
             if (now - _lastResolveTime >= MDNS_RECHECK_INTERVAL_MS) {
-                Serial.println("mDNS recheck: re-resolving host...");
+                LOG_D("mDNS recheck: re-resolving host...");
                 IPAddress ip;
                 if (!ip.fromString(WS_HOST)) {
                     // Only re-resolve if WS_HOST is a hostname, not a direct IP
                     String hostBare = stripLocalSuffix(WS_HOST);
                     ip = MDNS.queryHost(hostBare.c_str());
                     if (ip != IPAddress() && ip != _serverIP) {
-                        Serial.print("mDNS recheck: IP changed to ");
-                        Serial.println(ip);
+                        LOG_I("mDNS recheck: IP changed to %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
                         _serverIP = ip;
                         // Reconnect WebSocket with new IP
                         _ws.disconnect();
@@ -115,6 +307,8 @@ void AppNetworkManager::loop() {
         }
     }
 
+    if (WiFi.status() == WL_CONNECTED) serviceRoaming();
+
     _ws.loop();
 }
 
@@ -122,90 +316,60 @@ bool AppNetworkManager::isConnected() {
     return _wsConnected;
 }
 
-void AppNetworkManager::sendStart(String reqId) {
-    StaticJsonDocument<256> doc;
-    doc["type"] = "start";
-    doc["token"] = AUTH_TOKEN;
-    doc["reqId"] = reqId;
-    doc["mode"] = "paste";
-    doc["format"] = FORMAT;
-    doc["sampleRate"] = SAMPLE_RATE;
-    doc["channels"] = CHANNELS;
-    doc["bitDepth"] = BIT_DEPTH;
-
-    String out;
-    serializeJson(doc, out);
-    _ws.sendTXT(out);
-}
-
-void AppNetworkManager::sendEnd(String reqId) {
-    StaticJsonDocument<128> doc;
-    doc["type"] = "end";
-    doc["reqId"] = reqId;
-    String out;
-    serializeJson(doc, out);
-    _ws.sendTXT(out);
-}
-
-void AppNetworkManager::sendApprove() {
-    StaticJsonDocument<64> doc;
-    doc["type"] = "command";
-    doc["action"] = "approve";
-    String out;
-    serializeJson(doc, out);
-    _ws.sendTXT(out);
-}
-
-void AppNetworkManager::sendReject() {
-    StaticJsonDocument<64> doc;
-    doc["type"] = "command";
-    doc["action"] = "reject";
-    String out;
-    serializeJson(doc, out);
-    _ws.sendTXT(out);
-}
-
-void AppNetworkManager::sendBackspace() {
-    StaticJsonDocument<64> doc;
-    doc["type"] = "command";
-    doc["action"] = "backspace";
-    String out;
-    serializeJson(doc, out);
-    _ws.sendTXT(out);
-}
-
-void AppNetworkManager::sendToggleAutoApprove() {
-    StaticJsonDocument<64> doc;
-    doc["type"] = "command";
-    doc["action"] = "toggle_auto_approve";
-    String out;
-    serializeJson(doc, out);
-    _ws.sendTXT(out);
-}
-
-void AppNetworkManager::sendAudio(uint8_t* data, size_t len) {
-    if (_wsConnected) {
-        _ws.sendBIN(data, len);
+void AppNetworkManager::sendApprove(uint32_t pressUs) {
+    _link.postCommand(NET_CMD_APPROVE, "", micros(), pressUs);
+}
+
+void AppNetworkManager::sendReject(uint32_t pressUs) {
+    _link.postCommand(NET_CMD_REJECT, "", micros(), pressUs);
+}
+
+void AppNetworkManager::sendBackspace(uint32_t pressUs) {
+    _link.postCommand(NET_CMD_BACKSPACE, "", micros(), pressUs);
+}
+
+void AppNetworkManager::sendToggleAutoApprove(uint32_t pressUs) {
+    _link.postCommand(NET_CMD_TOGGLE_AUTO_APPROVE, "", micros(), pressUs);
+}
+
+void AppNetworkManager::sendStartMessage(const char* reqId) {
+    ArenaScope msg(_arena);
+    char* out = (char*)_arena.alloc(JSON_OUT_MAX_LEN);
+    sendText(out, protocolStart(out, JSON_OUT_MAX_LEN, AUTH_TOKEN, reqId));
+}
+
+void AppNetworkManager::sendEndMessage(const char* reqId) {
+    ArenaScope msg(_arena);
+    char* out = (char*)_arena.alloc(JSON_OUT_MAX_LEN);
+    sendText(out, protocolEnd(out, JSON_OUT_MAX_LEN, reqId));
+}
+
+void AppNetworkManager::sendCommandMessage(const char* action, uint32_t pressUs) {
+    ArenaScope msg(_arena);
+    char* out = (char*)_arena.alloc(JSON_OUT_MAX_LEN);
+    bool sent = sendText(out, protocolCommand(out, JSON_OUT_MAX_LEN, action));
+    if (sent && pressUs) {
+        uint32_t us = micros() - pressUs;
+        _pressToSend.record(us);
+        LOG_I("%s sent (press-to-send %lu us)", action, us);
     }
 }
 
-bool AppNetworkManager::seenId(const String &id) {
-  if (!id.length()) return false;
-  for (auto &s : _recentIds) {
-    if (s == id) return true;
-  }
-  _recentIds[_recentIdx++ % 16] = id;
-  return false;
+bool AppNetworkManager::sendText(char* out, size_t len) {
+    if (!len) {
+        LOG_E("Outbound message does not fit JSON_OUT_MAX_LEN (%u)", (unsigned)JSON_OUT_MAX_LEN);
+        return false;
+    }
+    return _ws.sendTXT(out, len);
 }
 
 void AppNetworkManager::handleHookEvent(const JsonDocument &doc) {
-  const char *idc = doc["id"] | "";
-  String id = String(idc);
-  if (id.length() && seenId(id)) return;
+  const char *id = doc["id"] | "";
+  if (_recentIds.seen(id)) return;
 
   const char *ev = doc["hook_event_name"] | "";
-  if (_hookCallback) {
-      _hookCallback(ev);
+  if (!_link.postHook(ev, micros())) {
+      LOG_W("Hook queue full, dropped %s", ev);
   }
 }
 
@@ -213,26 +377,26 @@ void AppNetworkManager::webSocketEvent(WStype_t type, uint8_t *payload, size_t l
   switch (type) {
   case WStype_DISCONNECTED:
     _wsConnected = false;
-    Serial.println("WS disconnected");
+    LOG_I("WS disconnected");
     break;
   case WStype_CONNECTED:
     _wsConnected = true;
-    Serial.println("WS connected");
-    Serial.println("DEBUG: [NM] WS Connected event received");
-    if (_hookCallback) {
-        Serial.println("DEBUG: [NM] Calling Connected hook");
-        _hookCallback("Connected");
-    }
+    _ipFromCache = false;
+    LOG_I("WS connected");
+    LOG_D("DEBUG: [NM] Queueing Connected hook");
+    _link.postHook("Connected", micros());
     break;
   case WStype_TEXT: {
-    String s;
-    s.reserve(length + 1);
-    for (size_t i = 0; i < length; i++) s += (char)payload[i];
-
-    StaticJsonDocument<1024> doc;
-    auto err = deserializeJson(doc, s);
+    // payload is NUL terminated by the WebSockets library
+    ArenaScope msg(_arena);
+    JsonDocument doc(&_jsonAlloc);
+    auto err = parseHookMessage(doc, (const char*)payload, length, _hookFilter);
+    if (err == DeserializationError::NoMemory) {
+      LOG_W("WS text does not fit the JSON arena (%u bytes)", (unsigned)length);
+      return;
+    }
     if (err) {
-      Serial.printf("WS text (non-json): %s\n", s.c_str());
+      LOG_D("WS text (non-json): %s", (const char*)payload);
       return;
     }
 
@@ -242,10 +406,108 @@ void AppNetworkManager::webSocketEvent(WStype_t type, uint8_t *payload, size_t l
       return;
     }
 
-    Serial.printf("WS json: %s\n", s.c_str());
+    LOG_D("WS json: %s", (const char*)payload);
     break;
   }
   default:
     break;
   }
 }
+
+void AppNetworkManager::serviceRoaming() {
+    uint32_t now = millis();
+    // Busy from the start message until the last queued frame has gone out.
+    // service() runs before drain(), so a START still in the command queue
+    // counts too: roaming then would cut the utterance's first frames.
+    bool busy = _uploading || !_link.audioQueue().empty() || !_link.commandQueue().empty();
+
+    if (_scanning) {
+        if (busy) {
+            // Utterance started mid-scan: give the radio back to the upload
+            esp_wifi_scan_stop();
+            WiFi.scanDelete();
+            _scanning = false;
+            return;
+        }
+        if (WiFi.scanComplete() == WIFI_SCAN_RUNNING) return;
+        finishScan(busy);
+        return;
+    }
+
+    if (now - _lastRssiMs >= ROAM_SAMPLE_MS) {
+        _lastRssiMs = now;
+        const uint8_t* bssid = WiFi.BSSID();
+        if (bssid && !_roam.isCurrent(bssid)) _roam.noteConnected(now, bssid);   // WiFiMulti moved us
+        _roam.noteRssi((int8_t)WiFi.RSSI());
+    }
+
+    if (_roam.shouldScan(now, busy)) {
+        LOG_I("Roam: weak link (rssi %d dBm, tx fail %d%%), scanning", (int)_roam.rssiEma(),
+              (int)(_roam.txFailEma() * 100));
+        // Async active scan, 120ms per channel; the current association stays up
+        _scanning = WiFi.scanNetworks(true, false, false, 120) == WIFI_SCAN_RUNNING;
+    }
+}
+
+void AppNetworkManager::finishScan(bool busy) {
+    _scanning = false;
+    int16_t n = WiFi.scanComplete();
+    if (n < 0) return;
+
+    RoamCandidate cands[ROAM_MAX_CANDIDATES];
+    size_t count = 0;
+    for (int16_t i = 0; i < n && count < (size_t)ROAM_MAX_CANDIDATES; i++) {
+        String ssid = WiFi.SSID(i);
+        for (size_t k = 0; k < WIFI_NETWORKS.size(); k++) {
+            if (ssid != WIFI_NETWORKS[k].ssid) continue;
+            RoamCandidate& c = cands[count++];
+            memcpy(c.bssid, WiFi.BSSID(i), sizeof(c.bssid));
+            c.netIndex = (uint8_t)k;
+            c.rssi = (int8_t)WiFi.RSSI(i);
+            c.channel = (uint8_t)WiFi.channel(i);
+            break;
+        }
+    }
+    WiFi.scanDelete();
+
+    int t = _roam.pickTarget(millis(), busy, cands, count);
+    if (t >= 0) {
+        roamTo(cands[t]);
+    } else {
+        LOG_D("Roam: no better BSSID among %u candidates", count);
+    }
+}
+
+void AppNetworkManager::roamTo(const RoamCandidate& target) {
+    const auto& cred = WIFI_NETWORKS[target.netIndex];
+    const uint8_t* b = target.bssid;
+    char bssid[18];
+    snprintf(bssid, sizeof(bssid), "%02x:%02x:%02x:%02x:%02x:%02x", b[0], b[1], b[2], b[3], b[4], b[5]);
+    LOG_I("Roam: %d dBm -> %s %s ch %u %d dBm", (int)_roam.rssiEma(), cred.ssid, bssid, target.channel,
+          target.rssi);
+
+    _ws.disconnect();
+    _wsConnected = false;
+    WiFi.disconnect();
+    WiFi.begin(cred.ssid, cred.password, target.channel, target.bssid);
+    uint32_t start = millis();
+    while (WiFi.status() != WL_CONNECTED && millis() - start < ROAM_CONNECT_TIMEOUT_MS) {
+        delay(20);
+    }
+    bool ok = WiFi.status() == WL_CONNECTED && !memcmp(WiFi.BSSID(), target.bssid, sizeof(target.bssid));
+    _roam.noteRoam(millis(), target, ok);
+    if (!ok) {
+        // No blocking retry here: service()'s WiFiMulti.run() reconnects on
+        // its next pass (bounded by its own connect timeout) and the
+        // WebSocket comes back on its reconnect interval
+        LOG_W("Roam: association failed, back to WiFiMulti");
+        WiFi.disconnect();
+        return;
+    }
+    LOG_I("Roam: associated in %lu ms", millis() - start);
+
+    // Re-open the WebSocket now rather than after the reconnect interval
+    if (_ipResolved) {
+        _ws.begin(_serverIP, WS_PORT, WS_PATH);
+    }
+}
@@ -4,53 +4,129 @@
 #include <WebSocketsClient.h>
 #include <ArduinoJson.h>
 #include <ESPmDNS.h>
+#include <atomic>
 #include "Config.h"
+#include "NetLink.h"
+#include "RoamPolicy.h"
+#include "MemoryBudget.h"
+#include "JsonArena.h"
+#include "Protocol.h"
 
-// Callback for received hook events
+// Callback for received hook events (runs on the main loop, never on the network task)
 typedef std::function<void(const char* eventName)> HookCallback;
 
+// Counters the network task owns, snapshotted for logMetrics()
+struct NetMetrics {
+    LatencyStat audioLatency;     // main -> net
+    LatencyStat commandLatency;   // main -> net
+    LatencyStat pressToSend;      // button edge -> sendTXT
+    uint32_t arenaUsed, arenaCapacity, arenaHighWater;
+    uint32_t arenaAllocs, arenaFailures;
+    RoamStats roam;
+    float rssiEma;
+};
+
+// WiFi, mDNS and the WebSocket run in a dedicated task pinned to
+// NET_TASK_CORE. The public API below is for the main loop only: send*
+// calls enqueue onto NetLink and return immediately; loop() delivers hook
+// events that the task queued.
 class AppNetworkManager {
 public:
-    void begin();
+    // Starts the network task. fastResume: try the AP and server IP cached
+    // before deep sleep first.
+    void begin(bool fastResume = false);
+    // Main side: delivers queued hook events to the HookCallback and logs
+    // a metrics snapshot the task has posted
     void loop();
+
+    // Cache AP/server details in RTC memory and turn the radio off.
+    // Blocks (bounded) until the network task has done it.
+    void prepareForDeepSleep();
     
     bool isConnected();
     
-    void sendStart(String reqId);
-    void sendEnd(String reqId);
-    void sendAudio(uint8_t* data, size_t len);
+    // Utterances (start / audio / end) are posted straight onto the link,
+    // see UploadFramer
+    NetLink& uplink() { return _link; }
 
-    // Claude Code control commands
-    void sendApprove();
-    void sendReject();
-    void sendBackspace();
-    void sendToggleAutoApprove();
+    // Claude Code control commands. pressUs: ButtonPress::tsUs of the
+    // press that triggered it, for the press-to-send metric (0 = none).
+    void sendApprove(uint32_t pressUs = 0);
+    void sendReject(uint32_t pressUs = 0);
+    void sendBackspace(uint32_t pressUs = 0);
+    void sendToggleAutoApprove(uint32_t pressUs = 0);
 
     void setHookCallback(HookCallback cb) { _hookCallback = cb; }
 
+    // Queue depth and hook latency now; the task's own counters (cross-core
+    // latency, press-to-send, arena, roaming) are plain fields, so this only
+    // asks the task for a snapshot and loop() logs it once posted.
+    void logMetrics();
+
 private:
+    // ---- Network task only ----
+    static void taskEntry(void* arg);
+    void taskLoop();
+    void service();
+    void onCommand(const NetCommand& cmd);
+    void onAudio(const AudioFrame& frame);
+    void sendStartMessage(const char* reqId);
+    void sendEndMessage(const char* reqId);
+    void sendCommandMessage(const char* action, uint32_t pressUs);
+    bool sendText(char* out, size_t len);
+    void postMetrics();
+    void logNetMetrics(const NetMetrics& m);
+    void shutdownRadio();
+    void serviceRoaming();
+    void finishScan(bool busy);
+    void roamTo(const RoamCandidate& target);
+
     void connectWiFi();
+    bool connectCachedAP();
     void resolveAndConnect();
     void webSocketEvent(WStype_t type, uint8_t *payload, size_t length);
     void handleHookEvent(const JsonDocument &doc);
-    bool seenId(const String &id);
 
     WiFiMulti _wifiMulti;
     WebSocketsClient _ws;
-    bool _wsConnected = false;
+    std::atomic<bool> _wsConnected{false};
+    std::atomic<bool> _radioOff{false};
+    NetLink _link;
+
+    // Set by logMetrics() (main), cleared by the task once it has posted a
+    // snapshot to _metrics (net -> main)
+    std::atomic<bool> _metricsRequested{false};
+    SpscQueue<NetMetrics, 2> _metrics;
+    LatencyStat _pressToSend;
     
     // mDNS resolved IP
     IPAddress _serverIP;
     bool _ipResolved = false;
     uint32_t _lastResolveTime = 0;  // millis() of last successful mDNS resolution
+    bool _fastResume = false;
+    bool _ipFromCache = false;      // _serverIP came from the resume cache, not mDNS
+
+    // Roaming (network task)
+    RoamPolicy _roam;
+    bool _scanning = false;
+    uint32_t _lastRssiMs = 0;
+    bool _uploading = false;        // between the start and end messages
+    uint32_t _uploadBytes = 0;
+    uint32_t _uploadStartUs = 0;    // start message handled
+    uint32_t _uploadLastUs = 0;     // last frame handed to the socket
 
     String stripLocalSuffix(const char* hostname);
 
     HookCallback _hookCallback;
-    
+
+    // Per-message JSON buffers (network task): the hook filter document sits
+    // at the bottom of the arena, each message is an ArenaScope on top.
+    StaticArena<MEM_NET_ARENA_BYTES> _arena;
+    JsonArenaAllocator _jsonAlloc{_arena};
+    JsonDocument _hookFilter{&_jsonAlloc};
+
     // De-dup
-    String _recentIds[16];
-    uint8_t _recentIdx = 0;
+    RecentIds _recentIds;
 };
 
 extern AppNetworkManager NetworkMgr;
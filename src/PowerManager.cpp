@@ -0,0 +1,73 @@
+#include "PowerManager.h"
+#include "LogTask.h"
+#include <WiFi.h>
+#include <esp_sleep.h>
+#include <driver/rtc_io.h>
+
+PowerManager PowerMgr;
+
+void PowerManager::begin() {
+    _resumed = (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT1);
+    _resumePending = _resumed;
+    if (_resumed) {
+        LOG_I("Power: woke from deep sleep (pins 0x%llx)", esp_sleep_get_ext1_wakeup_status());
+    }
+    _policy.begin(millis());
+    apply(POWER_PERFORMANCE);
+}
+
+PowerMode PowerManager::update(const PowerInputs& in) {
+    PowerMode m = _policy.update(millis(), in);
+    if (_policy.changed() && m != POWER_DEEP_SLEEP) apply(m);
+    return m;
+}
+
+void PowerManager::noteConnected() {
+    if (!_resumePending) return;
+    _resumePending = false;
+    // millis() restarts at boot, i.e. at the wake
+    _resumeToConnected.record(millis() * 1000);
+    LOG_I("Power: resume-to-connected %lu ms", millis());
+}
+
+void PowerManager::apply(PowerMode m) {
+    switch (m) {
+    case POWER_PERFORMANCE:
+        setCpuFrequencyMhz(240);
+        WiFi.setSleep(WIFI_PS_NONE);
+        break;
+    case POWER_MODEM_SLEEP:
+        setCpuFrequencyMhz(240);
+        WiFi.setSleep(WIFI_PS_MIN_MODEM);
+        break;
+    case POWER_LIGHT_SLEEP:
+        // Radio sleeps across several DTIM periods; CPU drops to the lowest
+        // clock WiFi supports. The CPU itself keeps running so the button
+        // ISRs stay armed.
+        WiFi.setSleep(WIFI_PS_MAX_MODEM);
+        setCpuFrequencyMhz(80);
+        break;
+    default:
+        return;
+    }
+    LOG_I("Power: %s", powerModeName(m));
+}
+
+void PowerManager::enterDeepSleep(const uint8_t* wakePins, uint8_t count) {
+    uint64_t mask = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        gpio_num_t pin = (gpio_num_t)wakePins[i];
+        if (!rtc_gpio_is_valid_gpio(pin)) continue;
+        rtc_gpio_pullup_en(pin);
+        rtc_gpio_pulldown_dis(pin);
+        mask |= (1ULL << wakePins[i]);
+    }
+    esp_sleep_enable_ext1_wakeup(mask, ESP_EXT1_WAKEUP_ANY_LOW);
+    // The buttons have no external pull-ups: the RTC pull-ups only hold if
+    // RTC_PERIPH stays powered, which ext1 wakeup does not force on
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);
+
+    LOG_I("Power: deep sleep, wake mask 0x%llx", mask);
+    LogOut.flush(200);
+    esp_deep_sleep_start();
+}
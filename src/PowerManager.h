@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+#include "PowerPolicy.h"
+
+// Applies PowerPolicy decisions to the radio/CPU and owns the deep sleep
+// entry and resume path.
+class PowerManager {
+public:
+    // Call first in setup(): records the wake cause, applies PERFORMANCE.
+    void begin();
+    // True when this boot is a wake from deep sleep (fast resume path).
+    bool resumedFromDeepSleep() const { return _resumed; }
+
+    // Re-evaluates the policy and applies any mode change.
+    PowerMode update(const PowerInputs& in);
+
+    // Radio is back (WS connected): closes the resume measurement.
+    void noteConnected();
+
+    // Arms the given RTC-capable pins (active LOW) as wake sources and
+    // enters deep sleep. Does not return.
+    void enterDeepSleep(const uint8_t* wakePins, uint8_t count);
+
+    PowerPolicy& policy() { return _policy; }
+    const LatencyStat& resumeToConnected() const { return _resumeToConnected; }
+
+private:
+    void apply(PowerMode m);
+
+    PowerPolicy _policy;
+    bool _resumed = false;
+    bool _resumePending = false;
+    LatencyStat _resumeToConnected;
+};
+
+extern PowerManager PowerMgr;
@@ -0,0 +1,64 @@
+#include "PowerPolicy.h"
+
+const char* powerModeName(PowerMode m) {
+    switch (m) {
+    case POWER_PERFORMANCE: return "performance";
+    case POWER_MODEM_SLEEP: return "modem-sleep";
+    case POWER_LIGHT_SLEEP: return "light-sleep";
+    case POWER_DEEP_SLEEP:  return "deep-sleep";
+    default:                return "?";
+    }
+}
+
+void PowerPolicy::begin(uint32_t nowMs) {
+    _mode = POWER_PERFORMANCE;
+    _changed = false;
+    _lastActivityMs = nowMs;
+    _lastHookMs = nowMs;
+    _prewarm = false;
+    _wakePending = false;
+}
+
+void PowerPolicy::noteActivity(uint32_t nowMs) {
+    _lastActivityMs = nowMs;
+}
+
+void PowerPolicy::noteBtnAPress(uint32_t nowMs) {
+    noteActivity(nowMs);
+    _prewarm = true;
+    _prewarmMs = nowMs;
+    _wakePending = true;
+    _wakeMode = _mode;   // the mode the radio is waking from
+    _wakeMs = nowMs;
+}
+
+void PowerPolicy::noteHook(uint32_t nowMs) {
+    _lastHookMs = nowMs;
+}
+
+void PowerPolicy::noteFirstFrame(uint32_t nowMs) {
+    if (!_wakePending) return;
+    _wakePending = false;
+    _wakeToFirstFrame[_wakeMode].record((nowMs - _wakeMs) * 1000);
+}
+
+PowerMode PowerPolicy::update(uint32_t nowMs, const PowerInputs& in) {
+    if (_prewarm && !within(nowMs, _prewarmMs, POWER_PREWARM_HOLD_MS)) _prewarm = false;
+
+    PowerMode next;
+    if (in.recording || _prewarm || within(nowMs, _lastActivityMs, POWER_ACTIVE_HOLD_MS)) {
+        next = POWER_PERFORMANCE;
+    } else if (in.pendingHooks > 0
+               || within(nowMs, _lastActivityMs, POWER_LIGHT_SLEEP_AFTER_MS)
+               || within(nowMs, _lastHookMs, POWER_LIGHT_SLEEP_AFTER_MS)) {
+        next = POWER_MODEM_SLEEP;
+    } else if (within(nowMs, _lastActivityMs, AUTO_SHUTDOWN_MS)) {
+        next = POWER_LIGHT_SLEEP;
+    } else {
+        next = POWER_DEEP_SLEEP;
+    }
+
+    _changed = (next != _mode);
+    _mode = next;
+    return next;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include "Config.h"
+#include "Metrics.h"
+
+enum PowerMode {
+    POWER_PERFORMANCE,   // WiFi power save off: lowest latency, highest draw
+    POWER_MODEM_SLEEP,   // WiFi min modem sleep (wakes every DTIM)
+    POWER_LIGHT_SLEEP,   // WiFi max modem sleep + CPU at 80 MHz (no auto light sleep)
+    POWER_DEEP_SLEEP,    // radio off, woken by the external buttons
+    POWER_MODE_COUNT,
+};
+
+const char* powerModeName(PowerMode m);
+
+// Inputs sampled by the caller on every update()
+struct PowerInputs {
+    bool recording;
+    uint8_t pendingHooks;   // hook beeps not yet played
+};
+
+// Decides the power mode from recording state, pending hooks and button
+// activity. Pure logic on a caller-supplied millisecond clock, so it runs
+// against a simulated clock on the host; PowerManager applies the result.
+//
+//   recording / BtnA pre-warm / recent button      -> PERFORMANCE
+//   idle < POWER_LIGHT_SLEEP_AFTER_MS or hooks due -> MODEM_SLEEP
+//   idle < AUTO_SHUTDOWN_MS                        -> LIGHT_SLEEP
+//   otherwise                                      -> DEEP_SLEEP
+class PowerPolicy {
+public:
+    void begin(uint32_t nowMs);
+
+    // Button activity (external buttons, BtnA)
+    void noteActivity(uint32_t nowMs);
+    // BtnA press: pre-warm the radio and start a wake-to-first-frame measurement
+    void noteBtnAPress(uint32_t nowMs);
+    // Hook event received: keeps the radio out of light sleep for a while
+    void noteHook(uint32_t nowMs);
+    // First audio frame sent after the last BtnA press
+    void noteFirstFrame(uint32_t nowMs);
+
+    // Returns the mode to apply now; changed() reports whether it differs
+    // from the previous update().
+    PowerMode update(uint32_t nowMs, const PowerInputs& in);
+    bool changed() const { return _changed; }
+    PowerMode mode() const { return _mode; }
+
+    // Wake-to-first-frame latency keyed by the mode the BtnA press woke from
+    const LatencyStat& wakeToFirstFrame(PowerMode m) const { return _wakeToFirstFrame[m]; }
+
+private:
+    static bool within(uint32_t nowMs, uint32_t sinceMs, uint32_t windowMs) {
+        return (uint32_t)(nowMs - sinceMs) < windowMs;
+    }
+
+    PowerMode _mode = POWER_PERFORMANCE;
+    bool _changed = false;
+
+    uint32_t _lastActivityMs = 0;
+    uint32_t _lastHookMs = 0;
+    uint32_t _prewarmMs = 0;
+    bool _prewarm = false;
+
+    bool _wakePending = false;
+    PowerMode _wakeMode = POWER_PERFORMANCE;
+    uint32_t _wakeMs = 0;
+    LatencyStat _wakeToFirstFrame[POWER_MODE_COUNT];
+};
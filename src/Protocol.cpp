@@ -0,0 +1,117 @@
+#include "Protocol.h"
+#include <stdio.h>
+#include <string.h>
+
+// ==================== JsonOut ====================
+
+JsonOut::JsonOut(char* buf, size_t cap) : _buf(buf), _cap(buf ? cap : 0) {
+    put('{');
+}
+
+void JsonOut::put(char c) {
+    if (_len + 1 >= _cap) {   // keep room for the terminator
+        _overflow = true;
+        return;
+    }
+    _buf[_len++] = c;
+}
+
+void JsonOut::putEscaped(const char* s) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    put('"');
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            put('\\');
+            put((char)c);
+        } else if (c < 0x20) {
+            put('\\');
+            put('u');
+            put('0');
+            put('0');
+            put(HEX_DIGITS[c >> 4]);
+            put(HEX_DIGITS[c & 15]);
+        } else {
+            put((char)c);
+        }
+    }
+    put('"');
+}
+
+void JsonOut::key(const char* k) {
+    if (!_first) put(',');
+    _first = false;
+    putEscaped(k);
+    put(':');
+}
+
+JsonOut& JsonOut::str(const char* k, const char* value) {
+    key(k);
+    putEscaped(value);
+    return *this;
+}
+
+JsonOut& JsonOut::num(const char* k, int32_t value) {
+    key(k);
+    char digits[12];
+    int n = snprintf(digits, sizeof(digits), "%ld", (long)value);
+    for (int i = 0; i < n; i++) put(digits[i]);
+    return *this;
+}
+
+size_t JsonOut::finish() {
+    put('}');
+    if (_overflow || !_cap) return 0;
+    _buf[_len] = '\0';
+    return _len;
+}
+
+// ==================== Messages ====================
+
+size_t protocolStart(char* out, size_t cap, const char* token, const char* reqId) {
+    JsonOut j(out, cap);
+    j.str("type", "start").str("token", token).str("reqId", reqId).str("mode", "paste");
+#if UPLOAD_LOGMEL
+    // Binary frames carry MEL_BINS int16 per 10ms frame instead of PCM
+    j.str("format", LOGMEL_FORMAT).num("nMels", MEL_BINS).num("nFft", MEL_N_FFT)
+        .num("hopLength", MEL_HOP).num("melScale", MEL_Q_SCALE);
+#else
+    j.str("format", FORMAT);
+#endif
+    j.num("sampleRate", SAMPLE_RATE).num("channels", CHANNELS).num("bitDepth", BIT_DEPTH);
+    return j.finish();
+}
+
+size_t protocolEnd(char* out, size_t cap, const char* reqId) {
+    return JsonOut(out, cap).str("type", "end").str("reqId", reqId).finish();
+}
+
+size_t protocolCommand(char* out, size_t cap, const char* action) {
+    return JsonOut(out, cap).str("type", "command").str("action", action).finish();
+}
+
+size_t protocolReqId(char* out, size_t cap, uint32_t mac, uint32_t ms) {
+    if (!out || !cap) return 0;
+    int n = snprintf(out, cap, "req-%lx-%lu", (unsigned long)mac, (unsigned long)ms);
+    if (n < 0) return 0;
+    return (size_t)n < cap ? (size_t)n : cap - 1;
+}
+
+// ==================== RecentIds ====================
+
+bool RecentIds::seen(const char* id) {
+    if (!id || !*id) return false;
+    for (const auto& s : _ids) {
+        if (s[0] && !strncmp(s, id, HOOK_ID_MAX_LEN - 1)) return true;
+    }
+    char* slot = _ids[_next];
+    _next = (uint8_t)((_next + 1) % HOOK_ID_DEDUP);
+    strncpy(slot, id, HOOK_ID_MAX_LEN - 1);
+    slot[HOOK_ID_MAX_LEN - 1] = '\0';
+    return false;
+}
+
+void RecentIds::clear() {
+    memset(_ids, 0, sizeof(_ids));
+    _next = 0;
+}
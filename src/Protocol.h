@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Config.h"
+
+// WebSocket protocol messages (see README "协议"), written into caller-owned
+// fixed buffers. Each builder returns the message length, or 0 if `out` is
+// null or too small (nothing partial is ever sent).
+
+// {"type":"start","token":...,"reqId":...,"mode":"paste","format":...,...}
+size_t protocolStart(char* out, size_t cap, const char* token, const char* reqId);
+// {"type":"end","reqId":...}
+size_t protocolEnd(char* out, size_t cap, const char* reqId);
+// {"type":"command","action":...}
+size_t protocolCommand(char* out, size_t cap, const char* action);
+
+// "req-<mac hex>-<ms>", truncated to cap - 1
+size_t protocolReqId(char* out, size_t cap, uint32_t mac, uint32_t ms);
+
+// Minimal JSON object writer over a fixed buffer. Strings are escaped;
+// overflow makes finish() return 0.
+class JsonOut {
+public:
+    JsonOut(char* buf, size_t cap);
+
+    JsonOut& str(const char* key, const char* value);
+    JsonOut& num(const char* key, int32_t value);
+    size_t finish();
+
+private:
+    void key(const char* k);
+    void put(char c);
+    void putEscaped(const char* s);
+
+    char* _buf;
+    size_t _cap;
+    size_t _len = 0;
+    bool _first = true;
+    bool _overflow = false;
+};
+
+// Hook event ids seen recently (the server may resend on reconnect).
+// Fixed ring of HOOK_ID_DEDUP ids; ids are compared up to HOOK_ID_MAX_LEN - 1
+// characters.
+class RecentIds {
+public:
+    // True if id was seen among the last HOOK_ID_DEDUP; otherwise records it.
+    // Empty ids are never duplicates.
+    bool seen(const char* id);
+    void clear();
+
+private:
+    char _ids[HOOK_ID_DEDUP][HOOK_ID_MAX_LEN] = {};
+    uint8_t _next = 0;
+};
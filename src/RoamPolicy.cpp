@@ -0,0 +1,97 @@
+#include "RoamPolicy.h"
+
+void RoamPolicy::begin(uint32_t nowMs) {
+    _samples = 0;
+    _rssiEma = 0.0f;
+    _txFailEma = 0.0f;
+    _scanned = false;
+    _roamed = false;
+    _everBusy = false;
+    _lastScanMs = nowMs;
+    _lastRoamMs = nowMs;
+}
+
+void RoamPolicy::noteConnected(uint32_t nowMs, const uint8_t* bssid) {
+    (void)nowMs;
+    memcpy(_bssid, bssid, sizeof(_bssid));
+    _samples = 0;
+    _txFailEma = 0.0f;
+}
+
+void RoamPolicy::noteRssi(int8_t rssi) {
+    if (_samples == 0) {
+        _rssiEma = rssi;
+    } else {
+        _rssiEma += ROAM_RSSI_ALPHA * (rssi - _rssiEma);
+    }
+    if (_samples < ROAM_MIN_SAMPLES) _samples++;
+}
+
+void RoamPolicy::noteTx(bool ok) {
+    _txFailEma += (1.0f / 16) * ((ok ? 0.0f : 1.0f) - _txFailEma);
+}
+
+void RoamPolicy::noteUpload(uint32_t bytes, uint32_t wallUs) {
+    if (!bytes || !wallUs) return;
+    _lastKbps = (uint32_t)((uint64_t)bytes * 8000 / wallUs);
+    if (_awaitPost) {
+        _stats.lastPostKbps = _lastKbps;
+        _awaitPost = false;
+    }
+}
+
+bool RoamPolicy::weak() const {
+    if (_samples < ROAM_MIN_SAMPLES) return false;
+    return _rssiEma < ROAM_RSSI_TRIGGER_DBM || _txFailEma > ROAM_TX_FAIL_TRIGGER;
+}
+
+bool RoamPolicy::quiet(uint32_t nowMs, bool busy) {
+    if (busy) {
+        _lastBusyMs = nowMs;
+        _everBusy = true;
+        return false;
+    }
+    return !_everBusy || !within(nowMs, _lastBusyMs, ROAM_IDLE_AFTER_MS);
+}
+
+bool RoamPolicy::shouldScan(uint32_t nowMs, bool busy) {
+    if (!quiet(nowMs, busy)) return false;
+    if (!weak()) return false;
+    if (_scanned && within(nowMs, _lastScanMs, ROAM_SCAN_INTERVAL_MS)) return false;
+    if (_roamed && within(nowMs, _lastRoamMs, ROAM_COOLDOWN_MS)) return false;
+    _scanned = true;
+    _lastScanMs = nowMs;
+    _stats.scans++;
+    return true;
+}
+
+int RoamPolicy::pickTarget(uint32_t nowMs, bool busy, const RoamCandidate* c, size_t n) {
+    // Results arriving after an utterance started (or stale ones) are dropped
+    if (!quiet(nowMs, busy)) return -1;
+    if (!_scanned || !within(nowMs, _lastScanMs, ROAM_SCAN_MAX_AGE_MS)) return -1;
+
+    int best = -1;
+    for (size_t i = 0; i < n; i++) {
+        if (!memcmp(c[i].bssid, _bssid, sizeof(_bssid))) continue;
+        if (c[i].rssi < _rssiEma + ROAM_HYSTERESIS_DB) continue;
+        if (best < 0 || c[i].rssi > c[best].rssi) best = (int)i;
+    }
+    return best;
+}
+
+void RoamPolicy::noteRoam(uint32_t nowMs, const RoamCandidate& target, bool ok) {
+    _roamed = true;
+    _lastRoamMs = nowMs;
+    if (!ok) {
+        _stats.failedRoams++;
+        return;
+    }
+    _stats.roams++;
+    _stats.lastFromRssi = (int8_t)_rssiEma;
+    _stats.lastToRssi = target.rssi;
+    _stats.lastPreKbps = _lastKbps;
+    _stats.lastPostKbps = 0;
+    _awaitPost = true;
+    noteConnected(nowMs, target.bssid);
+    noteRssi(target.rssi);
+}
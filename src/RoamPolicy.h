@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "Config.h"
+
+// One scanned BSSID of a configured network
+struct RoamCandidate {
+    uint8_t bssid[6];
+    uint8_t netIndex;   // index into WIFI_NETWORKS
+    int8_t rssi;
+    uint8_t channel;
+};
+
+struct RoamStats {
+    uint32_t scans = 0;
+    uint32_t roams = 0;
+    uint32_t failedRoams = 0;
+    int8_t lastFromRssi = 0;
+    int8_t lastToRssi = 0;
+    uint32_t lastPreKbps = 0;    // upload throughput of the last utterance before the roam
+    uint32_t lastPostKbps = 0;   // ... and of the first one after it (0 = none yet)
+};
+
+// Decides when to scan and which BSSID to roam to. Pure logic on a
+// caller-supplied millisecond clock, so RSSI traces can be replayed on the
+// host; AppNetworkManager does the scanning and switching.
+//
+// The link is considered weak when the smoothed RSSI is below
+// ROAM_RSSI_TRIGGER_DBM or the smoothed sendBIN failure rate is above
+// ROAM_TX_FAIL_TRIGGER (the Arduino WiFi API exposes no retry counters).
+// Nothing happens while busy (uploading) or within ROAM_IDLE_AFTER_MS of
+// it, and a target must beat the current link by ROAM_HYSTERESIS_DB.
+class RoamPolicy {
+public:
+    void begin(uint32_t nowMs);
+
+    // (Re)associated with `bssid`: restarts RSSI smoothing
+    void noteConnected(uint32_t nowMs, const uint8_t* bssid);
+    void noteRssi(int8_t rssi);
+    void noteTx(bool ok);
+    // One utterance: payload bytes and wall time from its start message to
+    // the last frame flushed to the socket
+    void noteUpload(uint32_t bytes, uint32_t wallUs);
+
+    // Should a background scan start now?
+    bool shouldScan(uint32_t nowMs, bool busy);
+    // Scan finished at nowMs: index of the candidate to roam to, or -1
+    int pickTarget(uint32_t nowMs, bool busy, const RoamCandidate* c, size_t n);
+    // Outcome of the switch to `target`
+    void noteRoam(uint32_t nowMs, const RoamCandidate& target, bool ok);
+
+    bool weak() const;
+    bool isCurrent(const uint8_t* bssid) const { return !memcmp(bssid, _bssid, sizeof(_bssid)); }
+    float rssiEma() const { return _rssiEma; }
+    float txFailEma() const { return _txFailEma; }
+    const RoamStats& stats() const { return _stats; }
+
+private:
+    static bool within(uint32_t nowMs, uint32_t sinceMs, uint32_t windowMs) {
+        return (uint32_t)(nowMs - sinceMs) < windowMs;
+    }
+    bool quiet(uint32_t nowMs, bool busy);
+
+    uint8_t _bssid[6] = {};
+    float _rssiEma = 0.0f;
+    int _samples = 0;
+    float _txFailEma = 0.0f;
+
+    bool _scanned = false;
+    bool _roamed = false;
+    uint32_t _lastScanMs = 0;
+    uint32_t _lastRoamMs = 0;
+    uint32_t _lastBusyMs = 0;
+    bool _everBusy = false;
+
+    uint32_t _lastKbps = 0;
+    bool _awaitPost = false;
+    RoamStats _stats;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bounded lock-free single-producer / single-consumer ring.
+//
+// One side may be an ISR or a task on the other core; neither side ever
+// blocks. head/tail are free-running counters, so all N slots are usable.
+// A full queue rejects the push and counts it in dropped().
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // Producer side
+    bool push(const T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t tail = _tail.load(std::memory_order_acquire);
+        if (head - tail >= N) {
+            _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        _buf[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+
+        uint32_t depth = head + 1 - tail;
+        if (depth > _highWater.load(std::memory_order_relaxed)) {
+            _highWater.store(depth, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Producer side, zero-copy: fill the returned slot, then commit().
+    // Returns nullptr (and counts a drop) when full.
+    T* reserve() {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N) {
+            _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &_buf[head & (N - 1)];
+    }
+    void commit() {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        _head.store(head + 1, std::memory_order_release);
+
+        uint32_t depth = head + 1 - _tail.load(std::memory_order_acquire);
+        if (depth > _highWater.load(std::memory_order_relaxed)) {
+            _highWater.store(depth, std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer side, zero-copy: inspect front(), then popFront().
+    T* front() {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (_head.load(std::memory_order_acquire) == tail) return nullptr;
+        return &_buf[tail & (N - 1)];
+    }
+    void popFront() {
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer side
+    bool pop(T& out) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        uint32_t head = _head.load(std::memory_order_acquire);
+        if (head == tail) return false;
+        out = _buf[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side (approximate while the other side is running)
+    size_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N; }
+
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+    uint32_t highWater() const { return _highWater.load(std::memory_order_relaxed); }
+
+private:
+    T _buf[N];
+    std::atomic<uint32_t> _head{0};
+    std::atomic<uint32_t> _tail{0};
+    std::atomic<uint32_t> _dropped{0};    // written by producer only
+    std::atomic<uint32_t> _highWater{0};  // written by producer only
+};
@@ -0,0 +1,47 @@
+#include "UploadFramer.h"
+#include <string.h>
+
+static_assert(LogMelExtractor::maxFramesFor(CHUNK_SAMPLES) <= MEL_FRAMES_PER_CHUNK_MAX, "mel output buffer too small");
+static_assert(LogMelExtractor::FLUSH_FRAMES_MAX <= MEL_FRAMES_PER_CHUNK_MAX, "mel flush buffer too small");
+
+UploadFramer::UploadFramer(NetLink& link, LogMelExtractor* mel, ClockUs nowUs)
+    : _link(link), _mel(mel), _nowUs(nowUs) {}
+
+void UploadFramer::start(const char* reqId) {
+    strncpy(_reqId, reqId ? reqId : "", sizeof(_reqId) - 1);
+    if (_mel) _mel->reset();
+    postCommand(NET_CMD_START);
+}
+
+void UploadFramer::chunk(const int16_t* pcm) {
+    if (!_mel) {
+        post(pcm, CHUNK_BYTES);
+        return;
+    }
+    uint32_t t0 = _nowUs();
+    size_t frames = _mel->push(pcm, CHUNK_SAMPLES, _melOut);
+    LogMelExtractor::quantize(_melOut, _feature, frames * MEL_BINS);
+    if (frames) _featureCost.record((_nowUs() - t0) / frames);
+    postFeatures(frames);
+}
+
+void UploadFramer::finish() {
+    if (_mel) {
+        size_t frames = _mel->flush(_melOut);
+        LogMelExtractor::quantize(_melOut, _feature, frames * MEL_BINS);
+        postFeatures(frames);
+    }
+    postCommand(NET_CMD_END);
+}
+
+void UploadFramer::postFeatures(size_t frames) {
+    if (frames) post(_feature, frames * MEL_BINS * sizeof(int16_t));
+}
+
+void UploadFramer::post(const void* data, size_t len) {
+    if (!_link.postAudio((const uint8_t*)data, len, _nowUs())) _dropped++;
+}
+
+void UploadFramer::postCommand(NetCommandType type) {
+    if (!_link.postCommand(type, _reqId, _nowUs())) _dropped++;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Config.h"
+#include "Metrics.h"
+#include "MelFrontend.h"
+#include "NetLink.h"
+
+// Frames one utterance onto NetLink (main side): the start command, every
+// recorded chunk as raw PCM or, with a LogMelExtractor, as quantized
+// log-mel frames (MEL_BINS int16 each, see MEL_Q_SCALE), then the trailing
+// feature frames and the end command.
+//
+// Hardware-free, so the firmware loop and bench/bench_pipeline.cpp run the
+// same framing code.
+class UploadFramer {
+public:
+    typedef uint32_t (*ClockUs)();
+
+    // mel == nullptr uploads PCM
+    UploadFramer(NetLink& link, LogMelExtractor* mel, ClockUs nowUs);
+
+    void start(const char* reqId);
+    void chunk(const int16_t* pcm);   // CHUNK_SAMPLES samples
+    void finish();
+
+    bool logMel() const { return _mel != nullptr; }
+    // Frames and commands NetLink rejected (queue full)
+    uint32_t dropped() const { return _dropped; }
+    const LatencyStat& featureFrameCost() const { return _featureCost; }   // per feature frame, us
+
+private:
+    void postFeatures(size_t frames);
+    void post(const void* data, size_t len);
+    void postCommand(NetCommandType type);
+
+    NetLink& _link;
+    LogMelExtractor* _mel;
+    ClockUs _nowUs;
+    char _reqId[REQ_ID_MAX_LEN] = {};
+    uint32_t _dropped = 0;
+    LatencyStat _featureCost;
+
+    float _melOut[MEL_FRAMES_PER_CHUNK_MAX * MEL_BINS];
+    int16_t _feature[MEL_FRAMES_PER_CHUNK_MAX * MEL_BINS];
+};
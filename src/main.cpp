@@ -3,16 +3,21 @@
 #include "Config.h"
 #include "AudioManager.h"
 #include "NetworkManager.h"
+#include "ButtonInput.h"
+#include "PowerManager.h"
+#include "LogTask.h"
+#include "Protocol.h"
+#include "MemoryBudget.h"
+#include "UploadFramer.h"
+
+#if UPLOAD_LOGMEL
+static LogMelExtractor melExtractor;
+static constexpr LogMelExtractor* UPLOAD_MEL = &melExtractor;
+#else
+static constexpr LogMelExtractor* UPLOAD_MEL = nullptr;
+#endif
 
-static String makeReqId() {
-  return String("req-") + String((uint32_t)ESP.getEfuseMac(), HEX) + String("-") + String(millis());
-}
-
-static String currentReqId;
-static int16_t audioBuf[CHUNK_SAMPLES];
-
-// Power management
-static const unsigned long AUTO_SHUTDOWN_MS = 5 * 60 * 1000; // 5 minutes
+// Power management (mode decisions in PowerPolicy)
 static unsigned long lastActivityMs = 0;
 
 // Keep-alive state
@@ -20,22 +25,16 @@ static unsigned long lastKeepaliveMs = 0;
 static bool keepalivePulseActive = false;
 static unsigned long pulseStartMs = 0;
 
-static void updateActivity() {
-    lastActivityMs = millis();
+// Current utterance as PCM, or as log-mel frames when UPLOAD_LOGMEL.
+// Built on first use: NetworkMgr lives in another translation unit.
+static UploadFramer& upload() {
+    static UploadFramer framer(NetworkMgr.uplink(), UPLOAD_MEL, []() -> uint32_t { return micros(); });
+    return framer;
 }
 
-static void checkAutoShutdown() {
-    if ((millis() - lastActivityMs) > AUTO_SHUTDOWN_MS) {
-        Serial.println("Auto shutdown timeout reached. Disabling WiFi...");
-        AudioMgr.queueBeep(BEEP_STOP); // Shutdown beep
-        delay(500); // Give time for beep
-        WiFi.disconnect(true);
-        WiFi.mode(WIFI_OFF);
-        // Enter infinite loop to stop activity
-        while (true) {
-            delay(1000);
-        }
-    }
+static void updateActivity() {
+    lastActivityMs = millis();
+    PowerMgr.policy().noteActivity(lastActivityMs);
 }
 
 static void keepAliveLoop() {
@@ -69,10 +68,86 @@ static void keepAliveLoop() {
     }
 }
 
+// External control buttons, indexed by ButtonPress::button
+struct BtnDef {
+    uint8_t pin;
+    const char* label;
+    void (AppNetworkManager::*handler)(uint32_t pressUs);
+};
+static const BtnDef buttons[] = {
+    {BTN_APPROVE_PIN,      "Approve",           &AppNetworkManager::sendApprove},
+    {BTN_REJECT_PIN,       "Reject",            &AppNetworkManager::sendReject},
+    {BTN_BACKSPACE_PIN,    "Backspace",         &AppNetworkManager::sendBackspace},
+    {BTN_AUTO_APPROVE_PIN, "ToggleAutoApprove", &AppNetworkManager::sendToggleAutoApprove},
+};
+static constexpr uint8_t BUTTON_COUNT = sizeof(buttons) / sizeof(buttons[0]);
+
+static void dispatchButtons() {
+    ButtonPress presses[BUTTON_COUNT * 2];
+    size_t n = ButtonIn.poll(presses, sizeof(presses) / sizeof(presses[0]));
+    for (size_t i = 0; i < n; i++) {
+        const BtnDef& b = buttons[presses[i].button];
+        updateActivity(); // Activity detected
+        if (NetworkMgr.isConnected()) {
+            // The network task logs press-to-send once it is on the socket
+            (NetworkMgr.*(b.handler))(presses[i].tsUs);
+            LOG_D("%s button queued", b.label);
+        } else {
+            LOG_W("%s button pressed but WS not connected", b.label);
+        }
+    }
+}
+
+static uint8_t pendingBeepCount() {
+    return AudioMgr.pendingBeeps(BEEP_START) + AudioMgr.pendingBeeps(BEEP_PERMISSION)
+         + AudioMgr.pendingBeeps(BEEP_FAILURE) + AudioMgr.pendingBeeps(BEEP_STOP);
+}
+
+static void updatePower() {
+    PowerMode mode = PowerMgr.update({AudioMgr.isRecording(), pendingBeepCount()});
+    if (mode != POWER_DEEP_SLEEP) return;
+
+    LOG_I("Auto shutdown timeout reached. Entering deep sleep...");
+    AudioMgr.queueBeep(BEEP_STOP); // Shutdown beep
+    AudioMgr.update();             // plays it (blocking)
+    NetworkMgr.prepareForDeepSleep();
+
+    // Any external button wakes the device (BtnA is not an RTC GPIO)
+    uint8_t pins[BUTTON_COUNT];
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) pins[i] = buttons[i].pin;
+    PowerMgr.enterDeepSleep(pins, BUTTON_COUNT);
+}
+
+static void logMetrics() {
+    static unsigned long lastLogMs = 0;
+    if (AudioMgr.isRecording() || millis() - lastLogMs < METRICS_LOG_INTERVAL_MS) return;
+    lastLogMs = millis();
+
+    LOG_I("Metrics:");
+    LOG_I("  button dropped edges %lu", ButtonIn.droppedEdges());
+    for (int m = POWER_PERFORMANCE; m < POWER_DEEP_SLEEP; m++) {
+        const LatencyStat& w = PowerMgr.policy().wakeToFirstFrame((PowerMode)m);
+        if (!w.count) continue;
+        LOG_I("  wake-to-first-frame from %s n=%lu avg %lu us max %lu us",
+              powerModeName((PowerMode)m), w.count, w.avgUs(), w.maxUs);
+    }
+    LOG_I("  source %s overruns %lu", AudioMgr.sourceName(), AudioMgr.sourceOverruns());
+#if UPLOAD_LOGMEL
+    const LatencyStat& mel = upload().featureFrameCost();
+    LOG_I("  log-mel cost per frame avg %lu us max %lu us", mel.avgUs(), mel.maxUs);
+#endif
+    NetworkMgr.logMetrics();
+    LOG_I("  log dropped %lu", LogOut.dropped());
+    LOG_I("  memory static %u B (budget %u B), heap free %u min %u largest block %u", (unsigned)MEM_TOTAL_BYTES,
+          (unsigned)APP_RAM_BUDGET_BYTES, ESP.getFreeHeap(), ESP.getMinFreeHeap(), ESP.getMaxAllocHeap());
+}
+
 void onHookEvent(const char* eventName) {
-    Serial.printf("DEBUG: [Main] Hook event: %s\n", eventName);
+    LOG_D("DEBUG: [Main] Hook event: %s", eventName);
+    PowerMgr.policy().noteHook(millis());
     if (!strcmp(eventName, "Connected")) {
-        Serial.println("DEBUG: [Main] Queueing BEEP_START");
+        PowerMgr.noteConnected();
+        LOG_D("DEBUG: [Main] Queueing BEEP_START");
         AudioMgr.queueBeep(BEEP_START);
     } else if (!strcmp(eventName, "PermissionRequest") || !strcmp(eventName, "Notification")) {
         AudioMgr.queueBeep(BEEP_PERMISSION);
@@ -87,91 +162,73 @@ void onHookEvent(const char* eventName) {
 __attribute__((weak)) void setup() {
     Serial.begin(115200);
     delay(200);
+    LogOut.begin();
+
+    PowerMgr.begin();
 
     AudioMgr.begin();
-    Serial.println("DEBUG: [Setup] Testing startup beep...");
-    AudioMgr.queueBeep(BEEP_START);
+    if (!PowerMgr.resumedFromDeepSleep()) {
+        LOG_D("DEBUG: [Setup] Testing startup beep...");
+        AudioMgr.queueBeep(BEEP_START);
+    }
 
     NetworkMgr.setHookCallback(onHookEvent);
-    NetworkMgr.begin();
+    NetworkMgr.begin(PowerMgr.resumedFromDeepSleep());
 
-    // External control buttons (active LOW with internal pull-up)
-    pinMode(BTN_APPROVE_PIN,      INPUT_PULLUP);
-    pinMode(BTN_REJECT_PIN,       INPUT_PULLUP);
-    pinMode(BTN_BACKSPACE_PIN,    INPUT_PULLUP);
-    pinMode(BTN_AUTO_APPROVE_PIN, INPUT_PULLUP);
+    // External control buttons (active LOW with internal pull-up, edge interrupts)
+    uint8_t pins[BUTTON_COUNT];
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) pins[i] = buttons[i].pin;
+    ButtonIn.begin(pins, BUTTON_COUNT);
 
     updateActivity();
 }
 
 __attribute__((weak)) void loop() {
+    // --- External control buttons (ISR-timestamped, debounced in ButtonInput) ---
+    // Dispatched first so a beep in update() cannot delay a queued press.
+    dispatchButtons();
+
     AudioMgr.update();
-    NetworkMgr.loop();
-    checkAutoShutdown();
-
-    // --- External control buttons (edge-triggered, active LOW) ---
-    {
-        struct BtnDef {
-            int pin;
-            const char* label;
-            void (AppNetworkManager::*handler)();
-        };
-        static const BtnDef buttons[] = {
-            {BTN_APPROVE_PIN,      "Approve",           &AppNetworkManager::sendApprove},
-            {BTN_REJECT_PIN,       "Reject",            &AppNetworkManager::sendReject},
-            {BTN_BACKSPACE_PIN,    "Backspace",         &AppNetworkManager::sendBackspace},
-            {BTN_AUTO_APPROVE_PIN, "ToggleAutoApprove", &AppNetworkManager::sendToggleAutoApprove},
-        };
-        static bool lastState[4] = {true, true, true, true}; // HIGH = not pressed
-        static unsigned long lastPressMs[4] = {0, 0, 0, 0};
-
-        for (int i = 0; i < 4; i++) {
-            bool cur = digitalRead(buttons[i].pin);
-            unsigned long now = millis();
-            if (cur == LOW && lastState[i] == HIGH && (now - lastPressMs[i]) > 15) {
-                Serial.printf("%s button pressed\n", buttons[i].label);
-                lastPressMs[i] = now;
-                updateActivity(); // Activity detected
-                if (NetworkMgr.isConnected()) {
-                    (NetworkMgr.*(buttons[i].handler))();
-                } else {
-                    Serial.printf("%s button pressed but WS not connected\n", buttons[i].label);
-                }
-            }
-            lastState[i] = cur;
-        }
-    }
+    NetworkMgr.loop();   // delivers hook events queued by the network task
+    updatePower();
+    logMetrics();
 
     // Button handling
     // M5.update() is called inside AudioMgr.update()
 
     if (!AudioMgr.isRecording() && M5.BtnA.wasPressed()) {
         updateActivity(); // Activity detected
+        // Pre-warm: radio to full performance before the start message goes out
+        PowerMgr.policy().noteBtnAPress(millis());
+        updatePower();
         if (!NetworkMgr.isConnected()) {
-            Serial.println("BtnA pressed but WS not connected");
+            LOG_W("BtnA pressed but WS not connected");
         } else {
-            Serial.println("Recording start");
+            LOG_I("Recording start");
             AudioMgr.startRecording();
-            currentReqId = makeReqId();
-            NetworkMgr.sendStart(currentReqId);
+            char reqId[REQ_ID_MAX_LEN];
+            protocolReqId(reqId, sizeof(reqId), (uint32_t)ESP.getEfuseMac(), millis());
+            upload().start(reqId);
         }
     }
 
     if (AudioMgr.isRecording()) {
         // Stop conditions
         if (M5.BtnA.wasReleased()) {
-             Serial.println("Recording stop (Btn released)");
+             LOG_I("Recording stop (Btn released)");
              AudioMgr.stopRecording();
-             NetworkMgr.sendEnd(currentReqId);
+             upload().finish();
         } else {
              // Record and send
-             if (AudioMgr.recordOneChunk(audioBuf, CHUNK_SAMPLES)) {
-                 NetworkMgr.sendAudio((uint8_t*)audioBuf, CHUNK_BYTES);
+             if (const int16_t* chunk = AudioMgr.acquireChunk()) {
+                 upload().chunk(chunk);
+                 AudioMgr.releaseChunk();
+                 PowerMgr.policy().noteFirstFrame(millis()); // no-op after the first
              } else {
                  // Check if it stopped implicitly (timeout)
                  if (!AudioMgr.isRecording()) {
-                     Serial.println("Recording stop (Timeout)");
-                     NetworkMgr.sendEnd(currentReqId);
+                     LOG_I("Recording stop (Timeout)");
+                     upload().finish();
                  }
              }
         }
@@ -0,0 +1,274 @@
+#include <unity.h>
+#include <atomic>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+#include "AudioSource.h"
+#include "JsonArena.h"
+#include "MemoryBudget.h"
+#include "NetLink.h"
+#include "Protocol.h"
+#include "UploadFramer.h"
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Every operator new in the test binary is counted, so the soak test can
+// show that the record / hook path never reaches the heap.
+static std::atomic<uint64_t> heapNews{0};
+
+void* operator new(size_t n) {
+    heapNews++;
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// ==================== 分配器 ====================
+
+void test_arena_allocations_are_aligned_and_disjoint(void) {
+    StaticArena<256> a;
+    uint8_t* p = (uint8_t*)a.alloc(3);
+    uint8_t* q = (uint8_t*)a.alloc(17);
+    TEST_ASSERT_NOT_NULL(p);
+    TEST_ASSERT_NOT_NULL(q);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)p % Arena::ALIGN);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)q % Arena::ALIGN);
+    TEST_ASSERT_TRUE(q >= p + 3);
+    TEST_ASSERT_EQUAL_size_t(Arena::blockBytes(3) + Arena::blockBytes(17), a.used());
+    TEST_ASSERT_EQUAL_UINT32(2, a.allocations());
+}
+
+void test_arena_full_returns_null_and_counts(void) {
+    StaticArena<Arena::blockBytes(100)> a;
+    TEST_ASSERT_NOT_NULL(a.alloc(100));
+    TEST_ASSERT_NULL(a.alloc(1));
+    TEST_ASSERT_NULL(a.alloc((size_t)-1));
+    TEST_ASSERT_EQUAL_UINT32(2, a.failures());
+    TEST_ASSERT_EQUAL_size_t(a.capacity(), a.used());
+}
+
+void test_arena_free_reclaims_top_only(void) {
+    StaticArena<256> a;
+    void* p = a.alloc(16);
+    void* q = a.alloc(16);
+    size_t afterP = Arena::blockBytes(16);
+    a.free(p);   // not the top: kept until rewind
+    TEST_ASSERT_EQUAL_size_t(2 * afterP, a.used());
+    a.free(q);
+    TEST_ASSERT_EQUAL_size_t(afterP, a.used());
+    a.free(p);   // p is the top again
+    TEST_ASSERT_EQUAL_size_t(0, a.used());
+    a.free(nullptr);
+    TEST_ASSERT_EQUAL_size_t(2 * afterP, a.highWater());
+}
+
+void test_arena_realloc_in_place_or_copy(void) {
+    StaticArena<512> a;
+    char* p = (char*)a.realloc(nullptr, 8);
+    strcpy(p, "abcdefg");
+    TEST_ASSERT_EQUAL_PTR(p, a.realloc(p, 100));   // top block grows in place
+    TEST_ASSERT_EQUAL_size_t(Arena::blockBytes(100), a.used());
+    TEST_ASSERT_EQUAL_PTR(p, a.realloc(p, 8));     // and shrinks in place
+    TEST_ASSERT_EQUAL_size_t(Arena::blockBytes(8), a.used());
+
+    char* q = (char*)a.alloc(8);
+    TEST_ASSERT_EQUAL_PTR(p, a.realloc(p, 4));     // shrinking a buried block keeps it
+    char* r = (char*)a.realloc(p, 64);             // growing one copies
+    TEST_ASSERT_TRUE(r != p && r > q);
+    TEST_ASSERT_EQUAL_STRING("abc", (r[3] = '\0', r));
+    TEST_ASSERT_NULL(a.realloc(r, 1024));
+    TEST_ASSERT_EQUAL_UINT32(1, a.failures());
+}
+
+void test_arena_scope_rewinds_and_finds_top(void) {
+    StaticArena<256> a;
+    void* session = a.alloc(24);
+    size_t base = a.used();
+    {
+        ArenaScope msg(a);
+        a.alloc(40);
+        a.alloc(40);
+        TEST_ASSERT_GREATER_THAN(base, a.used());
+    }
+    TEST_ASSERT_EQUAL_size_t(base, a.used());
+    // After the rewind the session block is the top again
+    a.free(session);
+    TEST_ASSERT_EQUAL_size_t(0, a.used());
+}
+
+// ==================== 长时间运行 ====================
+
+// Network side of NetLink with the socket replaced by a byte count
+struct CountingSink {
+    uint64_t bytes = 0;
+    uint32_t commands = 0;
+    void onCommand(const NetCommand&) { commands++; }
+    void onAudio(const AudioFrame& f) { bytes += f.len; }
+};
+
+static uint32_t soakNowUs = 0;
+static uint32_t soakNow() { return soakNowUs; }
+
+// ~4 KB of file content, as a Write tool_input carries it (escaped newlines
+// and quotes included)
+static const char* bigToolContent() {
+    static char content[4200];
+    if (!content[0]) {
+        size_t n = 0;
+        for (int line = 0; n + 64 < sizeof(content); line++) {
+            n += snprintf(content + n, sizeof(content) - n, "    LOG_I(\\\"line %d of the generated file\\\");\\n", line);
+        }
+    }
+    return content;
+}
+
+// Hook messages as the server forwards them: the hook event plus whatever
+// Claude Code sent, most of which the filter drops
+static size_t hookPayload(char* out, size_t cap, int kind, const char* id) {
+    static const char* SESSION = "\"session_id\":\"b3f1d0c2-5e6a-4f7b-8c9d-0a1b2c3d4e5f\","
+                                 "\"transcript_path\":\"/Users/dev/.claude/projects/demo/b3f1d0c2.jsonl\","
+                                 "\"cwd\":\"/Users/dev/src/demo\"";
+    int n = 0;
+    switch (kind) {
+    case 0:
+        n = snprintf(out, cap, "{\"type\":\"hook\",\"id\":\"%s\",\"hook_event_name\":\"Stop\",%s,"
+                     "\"stop_hook_active\":false}", id, SESSION);
+        break;
+    case 1:   // large tool_input
+        n = snprintf(out, cap, "{\"type\":\"hook\",\"id\":\"%s\",\"hook_event_name\":\"PermissionRequest\",%s,"
+                     "\"tool_name\":\"Write\",\"tool_input\":{\"file_path\":\"/Users/dev/src/demo/src/main.cpp\","
+                     "\"content\":\"%s\"},\"permission_suggestions\":[{\"type\":\"addRules\",\"rules\":"
+                     "[{\"toolName\":\"Write\"}],\"behavior\":\"allow\",\"destination\":\"session\"}]}",
+                     id, SESSION, bigToolContent());
+        break;
+    case 2:
+        n = snprintf(out, cap, "{\"type\":\"hook\",\"id\":\"%s\",\"hook_event_name\":\"PostToolUseFailure\",%s,"
+                     "\"tool_name\":\"Bash\",\"tool_input\":{\"command\":\"pio test -e native\",\"timeout\":120000},"
+                     "\"tool_response\":{\"stderr\":\"error: 3 tests failed\",\"exit_code\":1}}", id, SESSION);
+        break;
+    default:
+        n = snprintf(out, cap, "{\"type\":\"hook\",\"id\":\"%s\",\"hook_event_name\":\"Notification\",%s,"
+                     "\"message\":\"Claude needs your permission to use Bash\"}", id, SESSION);
+        break;
+    }
+    return n > 0 && (size_t)n < cap ? (size_t)n : 0;
+}
+
+void test_soak_record_and_hook_cycles_stay_off_heap(void) {
+    static StaticArena<MEM_NET_ARENA_BYTES> arena;
+    static JsonArenaAllocator jsonAlloc(arena);
+    static NetLink link;
+    static RecentIds recent;
+    static SynthSource mic;
+    static char reqId[REQ_ID_MAX_LEN];
+    static char payload[6144];
+    UploadFramer upload(link, nullptr, soakNow);
+    CountingSink sink;
+
+    // Filter document at the bottom of the arena, as on the network task
+    JsonDocument filter(&jsonAlloc);
+    buildHookFilter(filter);
+    TEST_ASSERT_FALSE(filter.overflowed());
+    TEST_ASSERT_EQUAL_UINT32(0, arena.failures());
+    const size_t sessionMark = arena.mark();
+    TEST_ASSERT_LESS_OR_EQUAL(JSON_FILTER_POOL_BYTES, sessionMark);
+
+    TEST_ASSERT_TRUE(mic.begin());
+    const char* events[] = {"Stop", "PermissionRequest", "PostToolUseFailure", "Notification"};
+    const int CYCLES = 5000;
+    const int CHUNKS_PER_RECORD = 25;   // 0.5 s utterances
+
+    uint64_t newsBefore = 0;
+    size_t heapBefore = 0;
+    size_t parsePeak = 0;
+    uint32_t hooksDelivered = 0;
+    for (int cycle = 0; cycle < CYCLES; cycle++) {
+        if (cycle == 1) {   // first cycle warms up anything lazily initialised
+            newsBefore = heapNews.load();
+            heapBefore = heapInUse();
+        }
+
+        // Record: request id, start, audio, end (main side then network side)
+        protocolReqId(reqId, sizeof(reqId), 0xdeadbeef, (uint32_t)cycle * 977);
+        upload.start(reqId);
+        {
+            ArenaScope msg(arena);
+            char* out = (char*)arena.alloc(JSON_OUT_MAX_LEN);
+            TEST_ASSERT_GREATER_THAN(0, protocolStart(out, JSON_OUT_MAX_LEN, "token", reqId));
+        }
+        for (int c = 0; c < CHUNKS_PER_RECORD; c++) {
+            const int16_t* pcm = mic.acquire(0);
+            TEST_ASSERT_NOT_NULL(pcm);
+            upload.chunk(pcm);
+            mic.release();
+            soakNowUs += 20000;
+            link.drain(sink, soakNow, NET_AUDIO_QUEUE_LEN);
+        }
+        upload.finish();
+        link.drain(sink, soakNow, NET_AUDIO_QUEUE_LEN);
+        {
+            ArenaScope msg(arena);
+            char* out = (char*)arena.alloc(JSON_OUT_MAX_LEN);
+            TEST_ASSERT_GREATER_THAN(0, protocolEnd(out, JSON_OUT_MAX_LEN, reqId));
+        }
+
+        // Hook: real filtered parse, de-dup (every third id is a resend),
+        // hand to the main side
+        char id[HOOK_ID_MAX_LEN];
+        snprintf(id, sizeof(id), "4f1c2b9e-8d7a-4c3b-9e2f-%012d", cycle - (cycle % 3 == 2));
+        size_t len = hookPayload(payload, sizeof(payload), cycle % 4, id);
+        TEST_ASSERT_GREATER_THAN(0, len);
+        {
+            ArenaScope msg(arena);   // before the document: it must go first
+            JsonDocument doc(&jsonAlloc);
+            DeserializationError err = parseHookMessage(doc, payload, len, filter);
+            TEST_ASSERT_EQUAL_STRING("Ok", err.c_str());
+            if (arena.used() - sessionMark > parsePeak) parsePeak = arena.used() - sessionMark;
+            TEST_ASSERT_EQUAL_STRING(events[cycle % 4], doc["hook_event_name"] | "");
+            TEST_ASSERT_EQUAL_STRING(id, doc["id"] | "");
+            TEST_ASSERT_TRUE(doc["tool_input"].isNull());   // filtered out
+            const char* ev = doc["hook_event_name"] | "";
+            if (!recent.seen(doc["id"] | "")) link.postHook(ev, soakNowUs);
+        }
+        HookEvent hook;
+        while (link.pollHook(hook, soakNowUs)) hooksDelivered++;
+
+        TEST_ASSERT_EQUAL_size_t(sessionMark, arena.used());
+    }
+
+    // The JSON_* budgets in Config.h are set from these
+    printf("  json arena: filter %u B (budget %u), parse peak %u B (budget %u), high water %u / %u\n",
+           (unsigned)sessionMark, (unsigned)JSON_FILTER_POOL_BYTES, (unsigned)parsePeak,
+           (unsigned)JSON_DOC_POOL_BYTES, (unsigned)arena.highWater(), (unsigned)MEM_NET_ARENA_BYTES);
+    TEST_ASSERT_EQUAL(0, heapNews.load() - newsBefore);
+    TEST_ASSERT_EQUAL(0, (long long)heapInUse() - (long long)heapBefore);
+    TEST_ASSERT_EQUAL_UINT32(0, arena.failures());
+    TEST_ASSERT_LESS_OR_EQUAL(JSON_DOC_POOL_BYTES, parsePeak);
+    TEST_ASSERT_LESS_OR_EQUAL(MEM_NET_ARENA_BYTES, arena.highWater());
+    TEST_ASSERT_EQUAL_UINT32(CYCLES * 2, sink.commands);
+    TEST_ASSERT_EQUAL((uint64_t)CYCLES * CHUNKS_PER_RECORD * CHUNK_BYTES, sink.bytes);
+    TEST_ASSERT_EQUAL_UINT32(CYCLES - CYCLES / 3, hooksDelivered);
+    TEST_ASSERT_EQUAL_UINT32(0, link.audioQueue().dropped());
+    TEST_ASSERT_EQUAL_UINT32(0, upload.dropped());
+}
+
+void run_arena_tests(void) {
+    RUN_TEST(test_arena_allocations_are_aligned_and_disjoint);
+    RUN_TEST(test_arena_full_returns_null_and_counts);
+    RUN_TEST(test_arena_free_reclaims_top_only);
+    RUN_TEST(test_arena_realloc_in_place_or_copy);
+    RUN_TEST(test_arena_scope_rewinds_and_finds_top);
+    RUN_TEST(test_soak_record_and_hook_cycles_stay_off_heap);
+}
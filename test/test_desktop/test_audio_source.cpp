@@ -0,0 +1,325 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include "AudioSource.h"
+
+static const char* TMP_PATH = "audio_source_test.bin";
+
+static void writeFile(const std::vector<uint8_t>& bytes) {
+    FILE* f = fopen(TMP_PATH, "wb");
+    fwrite(bytes.data(), 1, bytes.size(), f);
+    fclose(f);
+}
+
+static void put16(std::vector<uint8_t>& b, uint16_t v) {
+    b.push_back(v & 0xff);
+    b.push_back(v >> 8);
+}
+static void put32(std::vector<uint8_t>& b, uint32_t v) {
+    put16(b, v & 0xffff);
+    put16(b, v >> 16);
+}
+static void putTag(std::vector<uint8_t>& b, const char* tag) { b.insert(b.end(), tag, tag + 4); }
+
+// WAV with an extra LIST chunk before "data", as most editors write
+static std::vector<uint8_t> wav(const std::vector<int16_t>& samples, uint16_t channels, uint32_t rate) {
+    std::vector<uint8_t> b;
+    putTag(b, "RIFF");
+    put32(b, 0);   // patched below
+    putTag(b, "WAVE");
+    putTag(b, "fmt ");
+    put32(b, 16);
+    put16(b, 1);
+    put16(b, channels);
+    put32(b, rate);
+    put32(b, rate * channels * 2);
+    put16(b, channels * 2);
+    put16(b, 16);
+    putTag(b, "LIST");
+    put32(b, 5);
+    b.insert(b.end(), {'I', 'N', 'F', 'O', 'x', 0});   // odd size + pad byte
+    putTag(b, "data");
+    put32(b, (uint32_t)(samples.size() * 2));
+    for (int16_t s : samples) put16(b, (uint16_t)s);
+    uint32_t riffSize = (uint32_t)b.size() - 8;
+    memcpy(&b[4], &riffSize, 4);
+    return b;
+}
+
+static std::vector<int16_t> ramp(size_t n) {
+    std::vector<int16_t> v(n);
+    for (size_t i = 0; i < n; i++) v[i] = (int16_t)(i * 7 - 3000);
+    return v;
+}
+
+// Reads every block until the source stops
+static std::vector<int16_t> drainAll(AudioSource& src, size_t maxBlocks = 100000) {
+    std::vector<int16_t> out;
+    for (size_t i = 0; i < maxBlocks; i++) {
+        const int16_t* b = src.acquire(0);
+        if (!b) break;
+        out.insert(out.end(), b, b + CHUNK_SAMPLES);
+        src.release();
+    }
+    return out;
+}
+
+static float rms(const int16_t* s, size_t n) {
+    double acc = 0;
+    for (size_t i = 0; i < n; i++) acc += (double)s[i] * s[i];
+    return (float)sqrt(acc / n) / 32768.0f;
+}
+
+// ==================== 合成信号 ====================
+
+void test_synth_is_deterministic_per_seed(void) {
+    SynthParams p;
+    p.durationMs = 3000;
+    SynthSource a(p), b(p);
+    TEST_ASSERT_TRUE(a.begin());
+    TEST_ASSERT_TRUE(b.begin());
+    std::vector<int16_t> va = drainAll(a), vb = drainAll(b);
+    TEST_ASSERT_EQUAL_size_t(va.size(), vb.size());
+    TEST_ASSERT_TRUE(va == vb);
+
+    p.seed = 2;
+    SynthSource c(p);
+    c.begin();
+    TEST_ASSERT_FALSE(va == drainAll(c));
+
+    // begin() restarts the same stream
+    a.begin();
+    TEST_ASSERT_TRUE(va == drainAll(a));
+}
+
+void test_synth_tone_frequency_and_level(void) {
+    SynthParams p;
+    p.kind = SYNTH_TONE;
+    p.toneHz = 1000.0f;
+    p.amplitude = 0.5f;
+    p.durationMs = 1000;
+    SynthSource s(p);
+    s.begin();
+    std::vector<int16_t> v = drainAll(s);
+    TEST_ASSERT_EQUAL_size_t(SAMPLE_RATE, v.size());
+
+    int crossings = 0;
+    int16_t peak = 0;
+    for (size_t i = 1; i < v.size(); i++) {
+        if ((v[i - 1] < 0) != (v[i] < 0)) crossings++;
+        if (abs(v[i]) > peak) peak = (int16_t)abs(v[i]);
+    }
+    TEST_ASSERT_INT_WITHIN(4, 2000, crossings);
+    TEST_ASSERT_INT_WITHIN(100, 16384, peak);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f / sqrtf(2.0f), rms(v.data(), v.size()));
+}
+
+void test_synth_noise_is_full_band_and_bounded(void) {
+    SynthParams p;
+    p.kind = SYNTH_NOISE;
+    p.amplitude = 0.25f;
+    p.durationMs = 1000;
+    SynthSource s(p);
+    s.begin();
+    std::vector<int16_t> v = drainAll(s);
+    int16_t peak = 0;
+    double mean = 0;
+    for (int16_t x : v) {
+        if (abs(x) > peak) peak = (int16_t)abs(x);
+        mean += x;
+    }
+    mean /= v.size();
+    TEST_ASSERT_LESS_OR_EQUAL(8192, peak);
+    TEST_ASSERT_FLOAT_WITHIN(100.0, 0.0, mean);
+    // Uniform: rms = peak / sqrt(3)
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.25f / sqrtf(3.0f), rms(v.data(), v.size()));
+}
+
+void test_synth_speech_has_bursts_and_pauses(void) {
+    SynthParams p;
+    p.durationMs = 20000;
+    SynthSource s(p);
+    s.begin();
+    std::vector<int16_t> v = drainAll(s);
+    int voiced = 0, quiet = 0, transitions = 0;
+    bool wasVoiced = false;
+    for (size_t pos = 0; pos + CHUNK_SAMPLES <= v.size(); pos += CHUNK_SAMPLES) {
+        float r = rms(&v[pos], CHUNK_SAMPLES);
+        bool isVoiced = r > 0.03f;
+        if (isVoiced) voiced++;
+        if (r < 0.01f) quiet++;
+        if (pos && isVoiced != wasVoiced) transitions++;
+        wasVoiced = isVoiced;
+    }
+    int chunks = (int)(v.size() / CHUNK_SAMPLES);
+    TEST_ASSERT_GREATER_THAN(chunks / 4, voiced);
+    TEST_ASSERT_GREATER_THAN(chunks / 10, quiet);
+    TEST_ASSERT_GREATER_THAN(40, transitions);   // ~2.5 syllables per second
+}
+
+// ==================== 时长与节拍 ====================
+
+void test_source_end_of_stream_pads_last_block(void) {
+    SynthParams p;
+    p.kind = SYNTH_TONE;
+    p.durationMs = 1010;   // 50.5 chunks
+    SynthSource s(p);
+    s.begin();
+    const int16_t* b = nullptr;
+    for (int i = 0; i < 50; i++) {
+        b = s.acquire(0);
+        TEST_ASSERT_NOT_NULL(b);
+    }
+    TEST_ASSERT_TRUE(s.isRunning());
+    b = s.acquire(0);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_FALSE(s.isRunning());
+    TEST_ASSERT_EQUAL_INT16(0, b[CHUNK_SAMPLES / 2]);
+    TEST_ASSERT_EQUAL_INT16(0, b[CHUNK_SAMPLES - 1]);
+    TEST_ASSERT_NULL(s.acquire(0));
+    TEST_ASSERT_EQUAL_UINT32(16160, (uint32_t)s.samplesProduced());
+}
+
+static uint32_t fakeNowUs = 0;
+static uint32_t fakeClock() { return fakeNowUs; }
+
+void test_source_paced_like_a_microphone(void) {
+    SynthSource s;
+    s.pace(fakeClock);
+    fakeNowUs = 0xfffff000u;   // wraps during the test
+    s.begin();
+    const uint32_t chunkUs = CHUNK_SAMPLES * 1000000u / SAMPLE_RATE;
+
+    TEST_ASSERT_NULL(s.acquire(0));
+    fakeNowUs += chunkUs - 1;
+    TEST_ASSERT_NULL(s.acquire(0));
+    fakeNowUs += 1;
+    TEST_ASSERT_NOT_NULL(s.acquire(0));
+    TEST_ASSERT_NULL(s.acquire(0));
+
+    // A consumer that is late by a bit more than a chunk catches up
+    fakeNowUs += chunkUs * 2 + 500;
+    TEST_ASSERT_NOT_NULL(s.acquire(0));
+    TEST_ASSERT_NOT_NULL(s.acquire(0));
+    TEST_ASSERT_NULL(s.acquire(0));
+
+    // After a long stall (beep) it resumes at real time instead of bursting
+    fakeNowUs += 1000000;
+    TEST_ASSERT_NOT_NULL(s.acquire(0));
+    TEST_ASSERT_NULL(s.acquire(0));
+    fakeNowUs += chunkUs;
+    TEST_ASSERT_NOT_NULL(s.acquire(0));
+    TEST_ASSERT_EQUAL_UINT32(5 * CHUNK_SAMPLES, (uint32_t)s.samplesProduced());
+}
+
+// ==================== 文件 ====================
+
+void test_file_raw_pcm_round_trip(void) {
+    std::vector<int16_t> pcm = ramp(CHUNK_SAMPLES * 3 + 17);
+    std::vector<uint8_t> bytes((const uint8_t*)pcm.data(), (const uint8_t*)(pcm.data() + pcm.size()));
+    writeFile(bytes);
+
+    FileSource f(TMP_PATH);
+    TEST_ASSERT_TRUE(f.begin());
+    TEST_ASSERT_FALSE(f.isWav());
+    TEST_ASSERT_EQUAL_UINT32(pcm.size(), (uint32_t)f.totalSamples());
+    std::vector<int16_t> got = drainAll(f);
+    TEST_ASSERT_EQUAL_size_t(CHUNK_SAMPLES * 4, got.size());
+    TEST_ASSERT_TRUE(memcmp(got.data(), pcm.data(), pcm.size() * 2) == 0);
+    TEST_ASSERT_EQUAL_INT16(0, got.back());
+    TEST_ASSERT_FALSE(f.isRunning());
+    remove(TMP_PATH);
+}
+
+void test_file_wav_skips_unknown_chunks(void) {
+    std::vector<int16_t> pcm = ramp(CHUNK_SAMPLES * 2);
+    writeFile(wav(pcm, 1, SAMPLE_RATE));
+
+    FileSource f(TMP_PATH);
+    TEST_ASSERT_TRUE(f.begin());
+    TEST_ASSERT_TRUE(f.isWav());
+    std::vector<int16_t> got = drainAll(f);
+    TEST_ASSERT_TRUE(got == pcm);
+    remove(TMP_PATH);
+}
+
+void test_file_wav_stereo_is_downmixed(void) {
+    std::vector<int16_t> lr;
+    for (int i = 0; i < CHUNK_SAMPLES; i++) {
+        lr.push_back((int16_t)(1000 + i));
+        lr.push_back((int16_t)(-3000 + i));
+    }
+    writeFile(wav(lr, 2, SAMPLE_RATE));
+
+    FileSource f(TMP_PATH);
+    TEST_ASSERT_TRUE(f.begin());
+    TEST_ASSERT_EQUAL_UINT16(2, f.channels());
+    const int16_t* b = f.acquire(0);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_INT16(-1000, b[0]);
+    TEST_ASSERT_EQUAL_INT16(-1000 + CHUNK_SAMPLES - 1, b[CHUNK_SAMPLES - 1]);
+    remove(TMP_PATH);
+}
+
+void test_file_wav_wrong_format_rejected(void) {
+    writeFile(wav(ramp(100), 1, 44100));
+    FileSource f(TMP_PATH);
+    TEST_ASSERT_FALSE(f.begin());
+    TEST_ASSERT_FALSE(f.isRunning());
+    TEST_ASSERT_NULL(f.acquire(0));
+
+    FileSource missing("does/not/exist.wav");
+    TEST_ASSERT_FALSE(missing.begin());
+    remove(TMP_PATH);
+}
+
+void test_file_loop_wraps_to_data_start(void) {
+    std::vector<int16_t> pcm = ramp(CHUNK_SAMPLES + 100);
+    writeFile(wav(pcm, 1, SAMPLE_RATE));
+
+    FileSource f(TMP_PATH, true);
+    TEST_ASSERT_TRUE(f.begin());
+    std::vector<int16_t> got = drainAll(f, 10);
+    TEST_ASSERT_EQUAL_size_t(CHUNK_SAMPLES * 10, got.size());
+    for (size_t i = 0; i < got.size(); i++) {
+        if (got[i] != pcm[i % pcm.size()]) {
+            TEST_ASSERT_EQUAL_INT16(pcm[i % pcm.size()], got[i]);
+            break;
+        }
+    }
+    TEST_ASSERT_TRUE(f.isRunning());
+    remove(TMP_PATH);
+}
+
+void test_file_loop_stops_when_data_vanishes(void) {
+    std::vector<int16_t> pcm = ramp(CHUNK_SAMPLES * 40);   // well past one stdio buffer
+    writeFile(wav(pcm, 1, SAMPLE_RATE));
+
+    FileSource f(TMP_PATH, true);
+    TEST_ASSERT_TRUE(f.begin());
+    TEST_ASSERT_NOT_NULL(f.acquire(0));
+    f.release();
+    // Truncated while open: once stdio's buffer is used up, every read and
+    // rewind yields nothing, so the source must end rather than spin
+    writeFile({});
+    std::vector<int16_t> got = drainAll(f, 40);
+    TEST_ASSERT_LESS_THAN(CHUNK_SAMPLES * 40, got.size());
+    TEST_ASSERT_FALSE(f.isRunning());
+    remove(TMP_PATH);
+}
+
+void run_audio_source_tests(void) {
+    RUN_TEST(test_synth_is_deterministic_per_seed);
+    RUN_TEST(test_synth_tone_frequency_and_level);
+    RUN_TEST(test_synth_noise_is_full_band_and_bounded);
+    RUN_TEST(test_synth_speech_has_bursts_and_pauses);
+    RUN_TEST(test_source_end_of_stream_pads_last_block);
+    RUN_TEST(test_source_paced_like_a_microphone);
+    RUN_TEST(test_file_raw_pcm_round_trip);
+    RUN_TEST(test_file_wav_skips_unknown_chunks);
+    RUN_TEST(test_file_wav_stereo_is_downmixed);
+    RUN_TEST(test_file_wav_wrong_format_rejected);
+    RUN_TEST(test_file_loop_wraps_to_data_start);
+    RUN_TEST(test_file_loop_stops_when_data_vanishes);
+}
@@ -0,0 +1,172 @@
+#include <unity.h>
+#include "ButtonEvents.h"
+
+static constexpr uint32_t DB = BUTTON_DEBOUNCE_US;
+
+// Active LOW: press = level false, release = level true
+static void press(ButtonEventQueue& q, uint8_t b, uint32_t ts)   { q.pushEdge(b, false, ts); }
+static void release(ButtonEventQueue& q, uint8_t b, uint32_t ts) { q.pushEdge(b, true, ts); }
+
+// ==================== 基本按下 ====================
+
+void test_buttons_single_press_reports_edge_timestamp(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    press(q, 2, 1000);
+    size_t n = q.poll(1500, out, 4);
+    TEST_ASSERT_EQUAL(1, n);
+    TEST_ASSERT_EQUAL_UINT8(2, out[0].button);
+    TEST_ASSERT_EQUAL_UINT32(1000, out[0].tsUs);
+    TEST_ASSERT_TRUE(q.isPressed(2));
+}
+
+void test_buttons_no_edges_no_presses(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    TEST_ASSERT_EQUAL(0, q.poll(100000, out, 4));
+}
+
+void test_buttons_release_is_not_a_press(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    press(q, 0, 1000);
+    release(q, 0, 1000 + 2 * DB);
+    TEST_ASSERT_EQUAL(1, q.poll(1000 + 3 * DB, out, 4));
+    TEST_ASSERT_FALSE(q.isPressed(0));
+}
+
+// ==================== 去抖 ====================
+
+void test_buttons_press_chatter_yields_one_press(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    // Contact bounce: L H L H L within 3ms, stays LOW
+    press(q, 1, 10000);
+    release(q, 1, 10500);
+    press(q, 1, 11000);
+    release(q, 1, 11800);
+    press(q, 1, 13000);
+    TEST_ASSERT_EQUAL(1, q.poll(14000, out, 4));
+    TEST_ASSERT_EQUAL_UINT32(10000, out[0].tsUs);
+    // Nothing more after the window expires either
+    TEST_ASSERT_EQUAL(0, q.poll(10000 + 5 * DB, out, 4));
+    TEST_ASSERT_TRUE(q.isPressed(1));
+}
+
+void test_buttons_release_chatter_does_not_repress(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    press(q, 0, 0);
+    TEST_ASSERT_EQUAL(1, q.poll(100, out, 4));
+    // Release with bounce back to LOW, ends HIGH
+    release(q, 0, 100000);
+    press(q, 0, 100400);
+    release(q, 0, 100900);
+    TEST_ASSERT_EQUAL(0, q.poll(101000, out, 4));
+    TEST_ASSERT_EQUAL(0, q.poll(100000 + 2 * DB, out, 4));
+    TEST_ASSERT_FALSE(q.isPressed(0));
+}
+
+void test_buttons_two_presses_outside_window(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    press(q, 3, 1000);
+    release(q, 3, 1000 + DB + 1000);
+    press(q, 3, 1000 + 3 * DB);
+    TEST_ASSERT_EQUAL(2, q.poll(1000 + 4 * DB, out, 4));
+    TEST_ASSERT_EQUAL_UINT32(1000, out[0].tsUs);
+    TEST_ASSERT_EQUAL_UINT32(1000 + 3 * DB, out[1].tsUs);
+}
+
+void test_buttons_quick_tap_settles_after_window(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    // Release inside the lockout: must still be seen once the window passes
+    press(q, 0, 1000);
+    release(q, 0, 1000 + DB / 3);
+    TEST_ASSERT_EQUAL(1, q.poll(1000 + DB / 2, out, 4));
+    TEST_ASSERT_TRUE(q.isPressed(0));
+    TEST_ASSERT_EQUAL(0, q.poll(1000 + DB + 1, out, 4));
+    TEST_ASSERT_FALSE(q.isPressed(0));
+    // ...so the next real press is a new press
+    press(q, 0, 1000 + 3 * DB);
+    TEST_ASSERT_EQUAL(1, q.poll(1000 + 3 * DB + 10, out, 4));
+}
+
+void test_buttons_press_during_release_lockout_settles_as_press(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    press(q, 0, 0);
+    q.poll(10, out, 4);
+    release(q, 0, 2 * DB);
+    press(q, 0, 2 * DB + DB / 2);          // re-pressed inside release lockout
+    TEST_ASSERT_EQUAL(0, q.poll(2 * DB + DB / 2 + 10, out, 4));
+    TEST_ASSERT_EQUAL(1, q.poll(3 * DB + 10, out, 4));
+    TEST_ASSERT_EQUAL_UINT32(2 * DB + DB / 2, out[0].tsUs);
+}
+
+// ==================== 多按键 / 队列 ====================
+
+void test_buttons_independent_per_button(void) {
+    ButtonEventQueue q;
+    ButtonPress out[8];
+    press(q, 0, 1000);
+    press(q, 1, 1100);
+    press(q, 2, 1200);
+    press(q, 3, 1300);
+    TEST_ASSERT_EQUAL(4, q.poll(2000, out, 8));
+    for (uint8_t i = 0; i < 4; i++) TEST_ASSERT_EQUAL_UINT8(i, out[i].button);
+}
+
+void test_buttons_output_limit_keeps_remaining_edges(void) {
+    ButtonEventQueue q;
+    ButtonPress out[2];
+    press(q, 0, 1000);
+    press(q, 1, 1000);
+    press(q, 2, 1000);
+    TEST_ASSERT_EQUAL(2, q.poll(2000, out, 2));
+    TEST_ASSERT_EQUAL(1, q.poll(2000, out, 2));
+    TEST_ASSERT_EQUAL_UINT8(2, out[0].button);
+}
+
+void test_buttons_queue_overflow_counts_drops(void) {
+    ButtonEventQueue q;
+    for (uint32_t i = 0; i < BUTTON_EDGE_QUEUE_LEN + 5; i++) {
+        q.pushEdge(0, (i & 1) != 0, i * 10);
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, q.droppedEdges());
+}
+
+void test_buttons_out_of_range_button_ignored(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    press(q, ButtonEventQueue::MAX_BUTTONS, 1000);
+    TEST_ASSERT_EQUAL(0, q.poll(2000, out, 4));
+}
+
+void test_buttons_micros_wraparound(void) {
+    ButtonEventQueue q;
+    ButtonPress out[4];
+    uint32_t t0 = 0xFFFFFFFFu - 5000;
+    press(q, 0, t0);
+    release(q, 0, t0 + 2000);               // inside lockout, wraps nowhere yet
+    TEST_ASSERT_EQUAL(1, q.poll(t0 + 3000, out, 4));
+    TEST_ASSERT_EQUAL(0, q.poll(t0 + DB + 10, out, 4));   // wrapped past 0
+    TEST_ASSERT_FALSE(q.isPressed(0));
+}
+
+void run_button_events_tests(void) {
+    RUN_TEST(test_buttons_single_press_reports_edge_timestamp);
+    RUN_TEST(test_buttons_no_edges_no_presses);
+    RUN_TEST(test_buttons_release_is_not_a_press);
+    RUN_TEST(test_buttons_press_chatter_yields_one_press);
+    RUN_TEST(test_buttons_release_chatter_does_not_repress);
+    RUN_TEST(test_buttons_two_presses_outside_window);
+    RUN_TEST(test_buttons_quick_tap_settles_after_window);
+    RUN_TEST(test_buttons_press_during_release_lockout_settles_as_press);
+    RUN_TEST(test_buttons_independent_per_button);
+    RUN_TEST(test_buttons_output_limit_keeps_remaining_edges);
+    RUN_TEST(test_buttons_queue_overflow_counts_drops);
+    RUN_TEST(test_buttons_out_of_range_button_ignored);
+    RUN_TEST(test_buttons_micros_wraparound);
+}
@@ -0,0 +1,29 @@
+#include <unity.h>
+#include "CapturePolicy.h"
+
+// ==================== I2S DMA 接管判断 ====================
+
+void test_capture_std_i2s_mic_is_driven(void) {
+    TEST_ASSERT_TRUE(i2sDmaCanDrive({-1, 41, false, true}));
+    TEST_ASSERT_TRUE(i2sDmaCanDrive({-1, 41, false, false}));   // right slot too
+}
+
+void test_capture_codec_mic_declined(void) {
+    TEST_ASSERT_FALSE(i2sDmaCanDrive({0, 41, false, true}));
+}
+
+void test_capture_pdm_mic_declined(void) {
+    TEST_ASSERT_FALSE(i2sDmaCanDrive({-1, -1, false, true}));
+}
+
+void test_capture_adc_mic_declined(void) {
+    TEST_ASSERT_FALSE(i2sDmaCanDrive({-1, 41, true, true}));
+    TEST_ASSERT_FALSE(i2sDmaCanDrive({-1, -1, true, true}));
+}
+
+void run_capture_policy_tests(void) {
+    RUN_TEST(test_capture_std_i2s_mic_is_driven);
+    RUN_TEST(test_capture_codec_mic_declined);
+    RUN_TEST(test_capture_pdm_mic_declined);
+    RUN_TEST(test_capture_adc_mic_declined);
+}
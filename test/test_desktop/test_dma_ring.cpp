@@ -0,0 +1,147 @@
+#include <unity.h>
+#include "DmaRing.h"
+
+// Host stand-in for the I2S RX channel: cycles through its descriptor
+// buffers like the DMA engine, stamping every sample of a block with the
+// block's sequence number and then raising the completion callback.
+struct FakeDma {
+    static constexpr uint32_t DESC = I2S_DMA_DESC_NUM;
+    int16_t bufs[DESC][CHUNK_SAMPLES];
+    uint32_t next = 0;   // sequence of the block being written
+    DmaRing& ring;
+
+    explicit FakeDma(DmaRing& r) : ring(r) {}
+
+    void complete(uint32_t blocks = 1) {
+        for (uint32_t i = 0; i < blocks; i++) {
+            int16_t* b = bufs[next % DESC];
+            for (int s = 0; s < CHUNK_SAMPLES; s++) b[s] = (int16_t)next;
+            next++;
+            ring.onComplete(b);
+        }
+    }
+};
+
+// ==================== 零拷贝交接 ====================
+
+void test_dma_empty_ring_yields_nothing(void) {
+    DmaRing ring;
+    TEST_ASSERT_NULL(ring.acquire());
+    TEST_ASSERT_TRUE(ring.release());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.overruns());
+}
+
+void test_dma_hands_out_descriptor_buffer_in_place(void) {
+    DmaRing ring;
+    FakeDma dma(ring);
+    dma.complete();
+    const int16_t* b = ring.acquire();
+    TEST_ASSERT_EQUAL_PTR(dma.bufs[0], b);
+    TEST_ASSERT_TRUE(ring.release());
+    TEST_ASSERT_NULL(ring.acquire());
+}
+
+void test_dma_blocks_arrive_in_order_across_wrap(void) {
+    DmaRing ring;
+    FakeDma dma(ring);
+    for (uint32_t seq = 0; seq < 5 * FakeDma::DESC; seq++) {
+        dma.complete();
+        const int16_t* b = ring.acquire();
+        TEST_ASSERT_NOT_NULL(b);
+        TEST_ASSERT_EQUAL_INT16((int16_t)seq, b[0]);
+        TEST_ASSERT_EQUAL_INT16((int16_t)seq, b[CHUNK_SAMPLES - 1]);
+        TEST_ASSERT_TRUE(ring.release());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, ring.overruns());
+}
+
+void test_dma_acquire_repeats_until_release(void) {
+    DmaRing ring;
+    FakeDma dma(ring);
+    dma.complete(2);
+    const int16_t* a = ring.acquire();
+    TEST_ASSERT_EQUAL_PTR(a, ring.acquire());
+    ring.release();
+    TEST_ASSERT_EQUAL_PTR(dma.bufs[1], ring.acquire());
+}
+
+// ==================== 溢出 ====================
+
+void test_dma_backlog_within_ring_is_intact(void) {
+    DmaRing ring;
+    FakeDma dma(ring);
+    // DESC - 1 blocks done, DMA writing the last free descriptor
+    dma.complete(FakeDma::DESC - 1);
+    for (uint32_t seq = 0; seq < FakeDma::DESC - 1; seq++) {
+        const int16_t* b = ring.acquire();
+        TEST_ASSERT_NOT_NULL(b);
+        TEST_ASSERT_EQUAL_INT16((int16_t)seq, b[0]);
+        TEST_ASSERT_TRUE(ring.release());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, ring.overruns());
+}
+
+void test_dma_lapped_blocks_are_skipped_and_counted(void) {
+    DmaRing ring;
+    FakeDma dma(ring);
+    // Consumer stalls for DESC + 2 blocks: the oldest 3 were rewritten
+    dma.complete(FakeDma::DESC + 2);
+    const int16_t* b = ring.acquire();
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_INT16(3, b[0]);
+    TEST_ASSERT_EQUAL_UINT32(3, ring.overruns());
+    TEST_ASSERT_TRUE(ring.release());
+}
+
+void test_dma_block_overwritten_while_held(void) {
+    DmaRing ring;
+    FakeDma dma(ring);
+    dma.complete();
+    const int16_t* b = ring.acquire();
+    dma.complete(FakeDma::DESC - 1);      // DMA now writing the held buffer again
+    TEST_ASSERT_EQUAL_INT16(0, b[0]);     // write has not landed yet, but will
+    TEST_ASSERT_FALSE(ring.release());
+    TEST_ASSERT_EQUAL_UINT32(1, ring.overruns());
+}
+
+void test_dma_full_ready_queue_counts_drops(void) {
+    DmaRing ring;
+    FakeDma dma(ring);
+    const uint32_t total = I2S_DMA_READY_QUEUE_LEN + 4;
+    dma.complete(total);
+    // The last 4 completions were rejected by the full queue; of the queued
+    // ones only those younger than one lap are still intact.
+    const uint32_t firstIntact = total - FakeDma::DESC + 1;
+    const int16_t* b = ring.acquire();
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_INT16((int16_t)firstIntact, b[0]);
+    TEST_ASSERT_EQUAL_UINT32(4 + firstIntact, ring.overruns());
+    TEST_ASSERT_TRUE(ring.release());
+}
+
+void test_dma_reset_discards_idle_backlog(void) {
+    DmaRing ring;
+    FakeDma dma(ring);
+    dma.complete(3 * FakeDma::DESC);      // captured while not recording
+    ring.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, ring.overruns());
+    TEST_ASSERT_NULL(ring.acquire());
+    dma.complete();
+    const int16_t* b = ring.acquire();
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_INT16((int16_t)(3 * FakeDma::DESC), b[0]);
+    TEST_ASSERT_TRUE(ring.release());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.overruns());
+}
+
+void run_dma_ring_tests(void) {
+    RUN_TEST(test_dma_empty_ring_yields_nothing);
+    RUN_TEST(test_dma_hands_out_descriptor_buffer_in_place);
+    RUN_TEST(test_dma_blocks_arrive_in_order_across_wrap);
+    RUN_TEST(test_dma_acquire_repeats_until_release);
+    RUN_TEST(test_dma_backlog_within_ring_is_intact);
+    RUN_TEST(test_dma_lapped_blocks_are_skipped_and_counted);
+    RUN_TEST(test_dma_block_overwritten_while_held);
+    RUN_TEST(test_dma_full_ready_queue_counts_drops);
+    RUN_TEST(test_dma_reset_discards_idle_backlog);
+}
@@ -0,0 +1,204 @@
+#include <unity.h>
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Log.h"
+
+// Drains everything and returns the lines without the "[s.mmm] " prefix
+static std::vector<std::string> drainAll(Logger& log) {
+    std::vector<std::string> lines;
+    log.drain([&](const char* line, size_t len) {
+        const char* body = strstr(line, "] ");
+        TEST_ASSERT_NOT_NULL(body);
+        TEST_ASSERT_EQUAL(strlen(line), len);
+        lines.emplace_back(body + 2);
+    });
+    return lines;
+}
+
+// The single drained line, or a marker that fails the comparison
+static std::string one(Logger& log) {
+    std::vector<std::string> lines = drainAll(log);
+    if (lines.size() != 1) return "<" + std::to_string(lines.size()) + " lines>";
+    return lines[0];
+}
+
+// ==================== 格式化 ====================
+
+void test_log_integer_conversions_match_printf(void) {
+    static Logger log;
+    char expect[128];
+    int neg = -5;
+    uint8_t small = 200;
+    unsigned long ul = 4000000000ul;
+    long long ll = -1234567890123ll;
+    log.write(LOG_LEVEL_INFO, "%d %u %lu %lld %x %05d", neg, neg, ul, ll, 0xbeefu, small);
+    snprintf(expect, sizeof(expect), "%d %u %lu %lld %x %05d\n", neg, (unsigned)neg, ul, ll, 0xbeefu, (int)small);
+    TEST_ASSERT_EQUAL_STRING(expect, one(log).c_str());
+    log.write(LOG_LEVEL_INFO, "%c%hhd %hu", 'z', (int8_t)-3, (uint16_t)65535);
+    TEST_ASSERT_EQUAL_STRING("z-3 65535\n", one(log).c_str());
+}
+
+void test_log_length_modifier_mismatch_is_safe(void) {
+    static Logger log;
+    // uint32_t through %lu and size_t through %u both print the value
+    uint32_t hw = 7;
+    size_t depth = 3;
+    log.write(LOG_LEVEL_INFO, "hw %lu depth %u", hw, depth);
+    TEST_ASSERT_EQUAL_STRING("hw 7 depth 3\n", one(log).c_str());
+}
+
+void test_log_strings_floats_and_percent(void) {
+    static Logger log;
+    log.write(LOG_LEVEL_INFO, "  %-6s|%s %.2f 100%%", "cmd", "x", 3.14159);
+    TEST_ASSERT_EQUAL_STRING("  cmd   |x 3.14 100%\n", one(log).c_str());
+}
+
+void test_log_string_argument_is_copied(void) {
+    static Logger log;
+    char buf[16];
+    strcpy(buf, "before");
+    log.write(LOG_LEVEL_INFO, "WS json: %s", buf);
+    strcpy(buf, "after");
+    TEST_ASSERT_EQUAL_STRING("WS json: before\n", one(log).c_str());
+}
+
+void test_log_long_strings_are_truncated(void) {
+    static Logger log;
+    std::string big(200, 'a');
+    log.write(LOG_LEVEL_INFO, "%s|%s", big.c_str(), "tail");
+    std::string line = one(log);
+    // First string gets all but the terminator, the second one is empty
+    TEST_ASSERT_EQUAL_STRING((std::string(LOG_TEXT_BYTES - 1, 'a') + "|\n").c_str(), line.c_str());
+}
+
+void test_log_missing_argument_and_newline(void) {
+    static Logger log;
+    log.write(LOG_LEVEL_INFO, "a=%d b=%d\n", 1);
+    TEST_ASSERT_EQUAL_STRING("a=1 b=<?>\n", one(log).c_str());
+}
+
+void test_log_overlong_line_keeps_newline(void) {
+    static Logger log;
+    std::string s(LOG_TEXT_BYTES - 1, 'b');
+    log.write(LOG_LEVEL_INFO, "%s%s%s%s", s.c_str(), s.c_str(), s.c_str(), s.c_str());
+    log.write(LOG_LEVEL_INFO, "%s %s %s %s", s.c_str(), "x", "y", "z");
+    // Only one text buffer per record, so build an overlong line from width instead
+    log.write(LOG_LEVEL_INFO, "%300d", 1);
+    std::vector<std::string> lines = drainAll(log);
+    TEST_ASSERT_EQUAL(3, lines.size());
+    const std::string& l = lines[2];
+    TEST_ASSERT_TRUE(l.size() < (size_t)LOG_LINE_MAX);
+    TEST_ASSERT_EQUAL_INT('\n', l.back());
+}
+
+// ==================== 环形缓冲 ====================
+
+void test_log_records_drain_in_order(void) {
+    static Logger log;
+    for (int i = 0; i < 5; i++) log.write(LOG_LEVEL_INFO, "n=%d", i);
+    std::vector<std::string> lines = drainAll(log);
+    TEST_ASSERT_EQUAL(5, lines.size());
+    for (int i = 0; i < 5; i++) {
+        char expect[16];
+        snprintf(expect, sizeof(expect), "n=%d\n", i);
+        TEST_ASSERT_EQUAL_STRING(expect, lines[i].c_str());
+    }
+    TEST_ASSERT_EQUAL(0, log.pending());
+}
+
+void test_log_full_ring_drops_without_blocking(void) {
+    static Logger log;
+    for (uint32_t i = 0; i < LOG_RING_LEN + 10; i++) log.write(LOG_LEVEL_INFO, "n=%lu", i);
+    TEST_ASSERT_EQUAL_UINT32(10, log.dropped());
+    std::vector<std::string> lines = drainAll(log);
+    TEST_ASSERT_EQUAL(LOG_RING_LEN, lines.size());
+    TEST_ASSERT_EQUAL_STRING("n=0\n", lines[0].c_str());
+    // Space is reusable after draining
+    log.write(LOG_LEVEL_INFO, "again");
+    TEST_ASSERT_EQUAL_STRING("again\n", one(log).c_str());
+}
+
+void test_log_levels_filtered_at_compile_time(void) {
+    drainAll(Log);
+    LOG_D("debug %d", 1);
+    LOG_I("info %d", 2);
+    LOG_E("error %d", 3);
+    std::vector<std::string> lines = drainAll(Log);
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    TEST_ASSERT_EQUAL(3, lines.size());
+#else
+    TEST_ASSERT_EQUAL(2, lines.size());
+    TEST_ASSERT_EQUAL_STRING("info 2\n", lines[0].c_str());
+#endif
+}
+
+// Several threads play the loop and network task logging at once while a
+// consumer thread plays the log task.
+void test_log_multi_producer_stress(void) {
+    static Logger log;
+    const int PRODUCERS = 3;
+    const uint32_t PER_PRODUCER = 20000;
+    std::atomic<int> running{PRODUCERS};
+    uint32_t lastSeq[PRODUCERS];
+    uint32_t received[PRODUCERS] = {};
+    bool ordered = true;
+    for (int p = 0; p < PRODUCERS; p++) lastSeq[p] = UINT32_MAX;
+
+    std::thread consumer([&] {
+        auto sink = [&](const char* line, size_t) {
+            int p;
+            unsigned long seq;
+            if (sscanf(strstr(line, "] ") + 2, "p%d s%lu", &p, &seq) != 2 || p < 0 || p >= PRODUCERS) {
+                ordered = false;
+                return;
+            }
+            if (lastSeq[p] != UINT32_MAX && seq <= lastSeq[p]) ordered = false;
+            lastSeq[p] = (uint32_t)seq;
+            received[p]++;
+        };
+        for (;;) {
+            bool done = running.load() == 0;
+            if (log.drain(sink) == 0) {
+                if (done) break;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&, p] {
+            for (uint32_t s = 0; s < PER_PRODUCER; s++) {
+                log.write(LOG_LEVEL_INFO, "p%d s%lu", p, s);
+                if ((s & 63) == 0) std::this_thread::yield();
+            }
+            running--;
+        });
+    }
+    for (auto& t : producers) t.join();
+    consumer.join();
+
+    uint32_t total = 0;
+    for (int p = 0; p < PRODUCERS; p++) total += received[p];
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL_UINT32(PRODUCERS * PER_PRODUCER, total + log.dropped());
+    TEST_ASSERT_TRUE(total > 0);
+}
+
+void run_log_tests(void) {
+    RUN_TEST(test_log_integer_conversions_match_printf);
+    RUN_TEST(test_log_length_modifier_mismatch_is_safe);
+    RUN_TEST(test_log_strings_floats_and_percent);
+    RUN_TEST(test_log_string_argument_is_copied);
+    RUN_TEST(test_log_long_strings_are_truncated);
+    RUN_TEST(test_log_missing_argument_and_newline);
+    RUN_TEST(test_log_overlong_line_keeps_newline);
+    RUN_TEST(test_log_records_drain_in_order);
+    RUN_TEST(test_log_full_ring_drops_without_blocking);
+    RUN_TEST(test_log_levels_filtered_at_compile_time);
+    RUN_TEST(test_log_multi_producer_stress);
+}
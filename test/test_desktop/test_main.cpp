@@ -0,0 +1,41 @@
+#include <unity.h>
+
+// Host (native) test runner. Each module's tests live in their own file
+// and are registered through a run_*_tests() function.
+void run_button_events_tests(void);
+void run_power_policy_tests(void);
+void run_net_link_tests(void);
+void run_mel_frontend_tests(void);
+void run_dma_ring_tests(void);
+void run_log_tests(void);
+void run_roam_policy_tests(void);
+void run_audio_source_tests(void);
+void run_protocol_tests(void);
+void run_arena_tests(void);
+void run_upload_framer_tests(void);
+void run_capture_policy_tests(void);
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    run_button_events_tests();
+    run_power_policy_tests();
+    run_net_link_tests();
+    run_mel_frontend_tests();
+    run_dma_ring_tests();
+    run_log_tests();
+    run_roam_policy_tests();
+    run_audio_source_tests();
+    run_protocol_tests();
+    run_arena_tests();
+    run_upload_framer_tests();
+    run_capture_policy_tests();
+
+    return UNITY_END();
+}
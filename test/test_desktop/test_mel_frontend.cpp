@@ -0,0 +1,232 @@
+#include <unity.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "MelFrontend.h"
+
+// ==================== Reference implementation ====================
+// Straight transcription of whisper.audio.log_mel_spectrogram (minus the
+// per-utterance normalisation) in double precision: whole-signal reflect
+// padding, direct DFT, dense librosa Slaney filterbank.
+
+static double refHzToMel(double f) {
+    return f < 1000.0 ? f * 3.0 / 200.0 : 15.0 + log(f / 1000.0) * 27.0 / log(6.4);
+}
+static double refMelToHz(double m) {
+    return m < 15.0 ? m * 200.0 / 3.0 : 1000.0 * exp((m - 15.0) * log(6.4) / 27.0);
+}
+
+static double refFilter(int mel, int bin) {
+    double top = refHzToMel(8000.0);
+    double lo = refMelToHz(top * mel / 81.0);
+    double mid = refMelToHz(top * (mel + 1) / 81.0);
+    double hi = refMelToHz(top * (mel + 2) / 81.0);
+    double f = bin * 40.0;
+    double w = fmin((f - lo) / (mid - lo), (hi - f) / (hi - mid));
+    return w > 0.0 ? w * 2.0 / (hi - lo) : 0.0;
+}
+
+static std::vector<double> refLogMel(const std::vector<int16_t>& pcm) {
+    const int n = (int)pcm.size();
+    const int pad = MEL_N_FFT / 2;
+    std::vector<double> x(n + 2 * pad);
+    for (int i = 0; i < n; i++) x[pad + i] = pcm[i] / 32768.0;
+    for (int k = 1; k <= pad; k++) {
+        x[pad - k] = pcm[k] / 32768.0;
+        x[pad + n - 1 + k] = pcm[n - 1 - k] / 32768.0;
+    }
+    const int frames = n / MEL_HOP;
+    std::vector<double> out((size_t)frames * MEL_BINS);
+    std::vector<double> power(MEL_FFT_BINS);
+    for (int t = 0; t < frames; t++) {
+        for (int b = 0; b < MEL_FFT_BINS; b++) {
+            double re = 0, im = 0;
+            for (int i = 0; i < MEL_N_FFT; i++) {
+                double w = 0.5 - 0.5 * cos(2.0 * M_PI * i / MEL_N_FFT);
+                double v = x[t * MEL_HOP + i] * w;
+                re += v * cos(2.0 * M_PI * b * i / MEL_N_FFT);
+                im -= v * sin(2.0 * M_PI * b * i / MEL_N_FFT);
+            }
+            power[b] = re * re + im * im;
+        }
+        for (int m = 0; m < MEL_BINS; m++) {
+            double acc = 0;
+            for (int b = 0; b < MEL_FFT_BINS; b++) acc += refFilter(m, b) * power[b];
+            out[(size_t)t * MEL_BINS + m] = log10(acc > 1e-10 ? acc : 1e-10);
+        }
+    }
+    return out;
+}
+
+// Speech-ish test signal: two harmonics with a slow AM, plus LCG noise
+static std::vector<int16_t> testSignal(int n, uint32_t seed) {
+    std::vector<int16_t> s(n);
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        double noise = ((int32_t)(seed >> 16) - 32768) / 32768.0;
+        double env = 0.6 + 0.4 * sin(2.0 * M_PI * 3.0 * i / SAMPLE_RATE);
+        double v = env * (0.3 * sin(2.0 * M_PI * 440.0 * i / SAMPLE_RATE)
+                        + 0.2 * sin(2.0 * M_PI * 1870.0 * i / SAMPLE_RATE))
+                 + 0.05 * noise;
+        s[i] = (int16_t)lrint(v * 32767.0);
+    }
+    return s;
+}
+
+static std::vector<float> streamLogMel(LogMelExtractor& mel, const std::vector<int16_t>& pcm, size_t chunk) {
+    std::vector<float> out;
+    std::vector<float> buf(LogMelExtractor::maxFramesFor(chunk) * MEL_BINS);
+    for (size_t pos = 0; pos < pcm.size(); pos += chunk) {
+        size_t n = pcm.size() - pos < chunk ? pcm.size() - pos : chunk;
+        size_t f = mel.push(&pcm[pos], n, buf.data());
+        out.insert(out.end(), buf.begin(), buf.begin() + f * MEL_BINS);
+    }
+    std::vector<float> tail(LogMelExtractor::FLUSH_FRAMES_MAX * MEL_BINS);
+    size_t f = mel.flush(tail.data());
+    out.insert(out.end(), tail.begin(), tail.begin() + f * MEL_BINS);
+    return out;
+}
+
+static LogMelExtractor& extractor() {
+    static LogMelExtractor mel;   // large: keep off the stack
+    mel.reset();
+    return mel;
+}
+
+// ==================== FFT ====================
+
+void test_mel_fft_matches_direct_dft(void) {
+    LogMelExtractor& mel = extractor();
+    static float re[MEL_N_FFT], outRe[MEL_N_FFT], outIm[MEL_N_FFT];
+    uint32_t seed = 12345;
+    for (int i = 0; i < MEL_N_FFT; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        re[i] = ((int32_t)(seed >> 8) % 20000) / 20000.0f;
+    }
+    mel.fft(re, outRe, outIm);
+
+    double maxErr = 0;
+    for (int k = 0; k < MEL_N_FFT; k++) {
+        double dr = 0, di = 0;
+        for (int i = 0; i < MEL_N_FFT; i++) {
+            dr += re[i] * cos(2.0 * M_PI * k * i / MEL_N_FFT);
+            di -= re[i] * sin(2.0 * M_PI * k * i / MEL_N_FFT);
+        }
+        maxErr = fmax(maxErr, fabs(dr - outRe[k]));
+        maxErr = fmax(maxErr, fabs(di - outIm[k]));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 0.0, maxErr);
+}
+
+// ==================== Mel 滤波器组 ====================
+
+void test_mel_filterbank_matches_whisper_values(void) {
+    LogMelExtractor& mel = extractor();
+    // Leading entries of whisper's assets/mel_filters.npz (mel_80)
+    TEST_ASSERT_FLOAT_WITHIN(1e-7, 0.02486259, mel.filterWeight(0, 1));
+    TEST_ASSERT_FLOAT_WITHIN(1e-7, 0.00199082, mel.filterWeight(1, 1));
+    TEST_ASSERT_FLOAT_WITHIN(1e-7, 0.02287177, mel.filterWeight(1, 2));
+    TEST_ASSERT_FLOAT_WITHIN(1e-7, 0.00398164, mel.filterWeight(2, 2));
+    TEST_ASSERT_FLOAT_WITHIN(1e-7, 0.02088095, mel.filterWeight(2, 3));
+    TEST_ASSERT_FLOAT_WITHIN(1e-9, 0.0, mel.filterWeight(0, 0));
+}
+
+void test_mel_filterbank_matches_reference(void) {
+    LogMelExtractor& mel = extractor();
+    for (int m = 0; m < MEL_BINS; m++) {
+        for (int b = 0; b < MEL_FFT_BINS; b++) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-6, refFilter(m, b), mel.filterWeight(m, b));
+        }
+    }
+}
+
+// ==================== 流式输出 vs 参考实现 ====================
+
+static void checkAgainstReference(size_t chunk) {
+    LogMelExtractor& mel = extractor();
+    std::vector<int16_t> pcm = testSignal(SAMPLE_RATE / 2 + 77, 42);   // odd length on purpose
+    std::vector<double> ref = refLogMel(pcm);
+    std::vector<float> got = streamLogMel(mel, pcm, chunk);
+
+    TEST_ASSERT_EQUAL(ref.size(), got.size());
+    double maxErr = 0;
+    for (size_t i = 0; i < ref.size(); i++) maxErr = fmax(maxErr, fabs(ref[i] - got[i]));
+    // log10 domain: 1e-3 is ~0.2% in power
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 0.0, maxErr);
+}
+
+void test_mel_stream_matches_reference_chunk320(void) { checkAgainstReference(CHUNK_SAMPLES); }
+void test_mel_stream_matches_reference_odd_chunks(void) { checkAgainstReference(97); }
+
+void test_mel_frame_count_per_chunk(void) {
+    LogMelExtractor& mel = extractor();
+    std::vector<int16_t> pcm = testSignal(CHUNK_SAMPLES * 10, 7);
+    static float buf[MEL_FRAMES_PER_CHUNK_MAX * MEL_BINS];
+    size_t total = 0;
+    for (int c = 0; c < 10; c++) {
+        size_t f = mel.push(&pcm[c * CHUNK_SAMPLES], CHUNK_SAMPLES, buf);
+        TEST_ASSERT_LESS_OR_EQUAL(MEL_FRAMES_PER_CHUNK_MAX, f);
+        total += f;
+    }
+    total += mel.flush(buf);
+    TEST_ASSERT_EQUAL(CHUNK_SAMPLES * 10 / MEL_HOP, total);
+}
+
+void test_mel_reset_restarts_utterance(void) {
+    LogMelExtractor& mel = extractor();
+    std::vector<int16_t> pcm = testSignal(4000, 3);
+    std::vector<float> a = streamLogMel(mel, pcm, CHUNK_SAMPLES);
+    mel.reset();
+    std::vector<float> b = streamLogMel(mel, pcm, CHUNK_SAMPLES);
+    TEST_ASSERT_EQUAL(a.size(), b.size());
+    TEST_ASSERT_EQUAL(0, memcmp(a.data(), b.data(), a.size() * sizeof(float)));
+}
+
+void test_mel_tone_peaks_in_expected_bin(void) {
+    LogMelExtractor& mel = extractor();
+    std::vector<int16_t> pcm(SAMPLE_RATE / 4);
+    for (size_t i = 0; i < pcm.size(); i++) {
+        pcm[i] = (int16_t)lrint(16000.0 * sin(2.0 * M_PI * 1000.0 * i / SAMPLE_RATE));
+    }
+    std::vector<float> out = streamLogMel(mel, pcm, CHUNK_SAMPLES);
+    const float* frame = &out[10 * MEL_BINS];
+    int best = 0;
+    for (int m = 1; m < MEL_BINS; m++) if (frame[m] > frame[best]) best = m;
+    // Filter centred nearest 1 kHz (mel 15 on the Slaney scale)
+    int expect = (int)lround(15.0 / refHzToMel(8000.0) * 81.0) - 1;
+    TEST_ASSERT_INT_WITHIN(1, expect, best);
+}
+
+void test_mel_silence_floors_at_minus_ten(void) {
+    LogMelExtractor& mel = extractor();
+    std::vector<int16_t> pcm(CHUNK_SAMPLES * 4, 0);
+    std::vector<float> out = streamLogMel(mel, pcm, CHUNK_SAMPLES);
+    for (float v : out) TEST_ASSERT_FLOAT_WITHIN(1e-6, -10.0, v);
+}
+
+// ==================== 量化 ====================
+
+void test_mel_quantize_q8(void) {
+    float in[5] = {-10.0f, -1.5f, 0.0f, 2.25f, 200.0f};
+    int16_t out[5];
+    LogMelExtractor::quantize(in, out, 5);
+    TEST_ASSERT_EQUAL_INT16(-2560, out[0]);
+    TEST_ASSERT_EQUAL_INT16(-384, out[1]);
+    TEST_ASSERT_EQUAL_INT16(0, out[2]);
+    TEST_ASSERT_EQUAL_INT16(576, out[3]);
+    TEST_ASSERT_EQUAL_INT16(32767, out[4]);
+}
+
+void run_mel_frontend_tests(void) {
+    RUN_TEST(test_mel_fft_matches_direct_dft);
+    RUN_TEST(test_mel_filterbank_matches_whisper_values);
+    RUN_TEST(test_mel_filterbank_matches_reference);
+    RUN_TEST(test_mel_stream_matches_reference_chunk320);
+    RUN_TEST(test_mel_stream_matches_reference_odd_chunks);
+    RUN_TEST(test_mel_frame_count_per_chunk);
+    RUN_TEST(test_mel_reset_restarts_utterance);
+    RUN_TEST(test_mel_tone_peaks_in_expected_bin);
+    RUN_TEST(test_mel_silence_floors_at_minus_ten);
+    RUN_TEST(test_mel_quantize_q8);
+}
@@ -0,0 +1,268 @@
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "NetLink.h"
+
+// Records what the network side would have sent, in order
+struct RecordingSink {
+    struct Item {
+        bool isAudio;
+        NetCommandType type;
+        uint32_t seq;   // first 4 payload bytes of an audio frame
+        char reqId[REQ_ID_MAX_LEN];
+        uint32_t pressUs;
+    };
+    std::vector<Item> items;
+
+    void onCommand(const NetCommand& c) {
+        Item it{false, c.type, 0, {}, c.pressUs};
+        strcpy(it.reqId, c.reqId);
+        items.push_back(it);
+    }
+    void onAudio(const AudioFrame& f) {
+        Item it{true, NET_CMD_START, 0, {}, 0};
+        memcpy(&it.seq, f.data, sizeof(it.seq));
+        items.push_back(it);
+    }
+};
+
+static uint32_t fakeNowUs = 0;
+static uint32_t fakeNow() { return fakeNowUs; }
+
+static uint32_t steadyUs() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static bool postSeqFrame(NetLink& link, uint32_t seq, uint32_t nowUs) {
+    uint8_t buf[CHUNK_BYTES];
+    memset(buf, (int)(seq & 0xFF), sizeof(buf));
+    memcpy(buf, &seq, sizeof(seq));
+    return link.postAudio(buf, sizeof(buf), nowUs);
+}
+
+// ==================== 顺序保证 ====================
+
+void test_netlink_start_audio_end_order(void) {
+    NetLink link;
+    RecordingSink sink;
+
+    link.postCommand(NET_CMD_START, "req-1", 0);
+    for (uint32_t i = 0; i < 5; i++) postSeqFrame(link, i, 0);
+    link.postCommand(NET_CMD_END, "req-1", 0);
+
+    // End must not overtake the frames posted before it
+    TEST_ASSERT_EQUAL(7, link.drain(sink, fakeNow, 100));
+    TEST_ASSERT_FALSE(sink.items[0].isAudio);
+    TEST_ASSERT_EQUAL(NET_CMD_START, sink.items[0].type);
+    TEST_ASSERT_EQUAL_STRING("req-1", sink.items[0].reqId);
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(sink.items[1 + i].isAudio);
+        TEST_ASSERT_EQUAL_UINT32(i, sink.items[1 + i].seq);
+    }
+    TEST_ASSERT_EQUAL(NET_CMD_END, sink.items[6].type);
+}
+
+void test_netlink_button_command_interleaves_with_audio(void) {
+    NetLink link;
+    RecordingSink sink;
+
+    postSeqFrame(link, 0, 0);
+    postSeqFrame(link, 1, 0);
+    link.postCommand(NET_CMD_APPROVE, "", 0);
+    postSeqFrame(link, 2, 0);
+
+    TEST_ASSERT_EQUAL(4, link.drain(sink, fakeNow, 100));
+    TEST_ASSERT_TRUE(sink.items[0].isAudio);
+    TEST_ASSERT_TRUE(sink.items[1].isAudio);
+    TEST_ASSERT_EQUAL(NET_CMD_APPROVE, sink.items[2].type);
+    TEST_ASSERT_TRUE(sink.items[3].isAudio);
+}
+
+void test_netlink_drain_respects_max(void) {
+    NetLink link;
+    RecordingSink sink;
+    for (uint32_t i = 0; i < 6; i++) postSeqFrame(link, i, 0);
+    TEST_ASSERT_EQUAL(4, link.drain(sink, fakeNow, 4));
+    TEST_ASSERT_EQUAL(2, link.drain(sink, fakeNow, 4));
+    TEST_ASSERT_EQUAL(0, link.drain(sink, fakeNow, 4));
+}
+
+void test_netlink_long_req_id_truncated(void) {
+    NetLink link;
+    RecordingSink sink;
+    char longId[REQ_ID_MAX_LEN * 2];
+    memset(longId, 'x', sizeof(longId) - 1);
+    longId[sizeof(longId) - 1] = '\0';
+    link.postCommand(NET_CMD_START, longId, 0);
+    link.drain(sink, fakeNow, 1);
+    TEST_ASSERT_EQUAL(REQ_ID_MAX_LEN - 1, strlen(sink.items[0].reqId));
+}
+
+// ==================== 背压 / 指标 ====================
+
+void test_netlink_full_audio_queue_drops_and_keeps_order(void) {
+    NetLink link;
+    RecordingSink sink;
+
+    link.postCommand(NET_CMD_START, "r", 0);
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < NET_AUDIO_QUEUE_LEN + 4; i++) {
+        if (postSeqFrame(link, i, 0)) accepted++;
+    }
+    link.postCommand(NET_CMD_END, "r", 0);
+
+    TEST_ASSERT_EQUAL_UINT32(NET_AUDIO_QUEUE_LEN, accepted);
+    TEST_ASSERT_EQUAL_UINT32(4, link.audioQueue().dropped());
+    TEST_ASSERT_EQUAL_UINT32(NET_AUDIO_QUEUE_LEN, link.audioQueue().highWater());
+
+    link.drain(sink, fakeNow, 100);
+    // Dropped frames do not hold the end command back
+    TEST_ASSERT_EQUAL(NET_AUDIO_QUEUE_LEN + 2, sink.items.size());
+    TEST_ASSERT_EQUAL(NET_CMD_END, sink.items.back().type);
+}
+
+void test_netlink_oversized_frame_rejected(void) {
+    NetLink link;
+    static uint8_t big[CHUNK_BYTES + 1];
+    TEST_ASSERT_FALSE(link.postAudio(big, sizeof(big), 0));
+    TEST_ASSERT_EQUAL(0, link.audioQueue().size());
+}
+
+void test_netlink_latency_metrics(void) {
+    NetLink link;
+    RecordingSink sink;
+
+    postSeqFrame(link, 0, 1000);
+    link.postCommand(NET_CMD_REJECT, "", 1500, 1200);   // button pressed at 1200
+    fakeNowUs = 4000;
+    link.drain(sink, fakeNow, 10);
+    TEST_ASSERT_EQUAL_UINT32(3000, link.audioLatency().lastUs);
+    TEST_ASSERT_EQUAL_UINT32(2500, link.commandLatency().lastUs);
+    // The press time rides along for the sink's press-to-send
+    TEST_ASSERT_EQUAL_UINT32(1200, sink.items.back().pressUs);
+
+    link.postHook("Stop", 10000);
+    HookEvent ev;
+    TEST_ASSERT_TRUE(link.pollHook(ev, 10250));
+    TEST_ASSERT_EQUAL_STRING("Stop", ev.name);
+    TEST_ASSERT_EQUAL_UINT32(250, link.hookLatency().lastUs);
+    TEST_ASSERT_FALSE(link.pollHook(ev, 10300));
+}
+
+// ==================== 多线程压力测试 ====================
+
+// Main thread plays the Arduino loop, a second thread plays the network task.
+// Both directions run at once; every item must arrive exactly once, in order.
+void test_netlink_threaded_stress(void) {
+    NetLink link;
+    const uint32_t FRAMES = 200000;
+    const uint32_t HOOKS = 20000;
+
+    std::atomic<bool> mainDone{false};
+    std::atomic<uint32_t> badOrder{0};
+    std::atomic<uint32_t> framesSeen{0};
+    std::atomic<uint32_t> cmdsSeen{0};
+
+    std::thread net([&] {
+        struct Sink {
+            std::atomic<uint32_t>& bad;
+            std::atomic<uint32_t>& frames;
+            std::atomic<uint32_t>& cmds;
+            uint32_t expectSeq = 0;
+            uint32_t lastFrameAtCmd = 0;
+            void onAudio(const AudioFrame& f) {
+                uint32_t seq;
+                memcpy(&seq, f.data, sizeof(seq));
+                if (seq != expectSeq || f.data[CHUNK_BYTES - 1] != (uint8_t)(seq & 0xFF)) bad++;
+                expectSeq = seq + 1;
+                frames++;
+            }
+            void onCommand(const NetCommand& c) {
+                // reqId carries the frame count posted before the command
+                uint32_t after = (uint32_t)strtoul(c.reqId, nullptr, 10);
+                if (after != expectSeq) bad++;
+                cmds++;
+            }
+        } sink{badOrder, framesSeen, cmdsSeen};
+
+        uint32_t hooksSent = 0;
+        while (!mainDone || !link.audioQueue().empty() || !link.commandQueue().empty()) {
+            if (link.drain(sink, steadyUs, 8) == 0) std::this_thread::yield();
+            if (hooksSent < HOOKS) {
+                char name[16];
+                snprintf(name, sizeof(name), "h%lu", (unsigned long)hooksSent);
+                if (link.postHook(name, steadyUs())) hooksSent++;
+            }
+        }
+        while (hooksSent < HOOKS) {
+            char name[16];
+            snprintf(name, sizeof(name), "h%lu", (unsigned long)hooksSent);
+            if (link.postHook(name, steadyUs())) hooksSent++;
+            else std::this_thread::yield();
+        }
+    });
+
+    uint32_t posted = 0;
+    uint32_t hooksGot = 0;
+    uint32_t hookBad = 0;
+    HookEvent ev;
+    while (posted < FRAMES) {
+        if (postSeqFrame(link, posted, steadyUs())) {
+            posted++;
+            if (posted % 64 == 0) {
+                char id[16];
+                snprintf(id, sizeof(id), "%lu", (unsigned long)posted);
+                while (!link.postCommand(NET_CMD_APPROVE, id, steadyUs())) std::this_thread::yield();
+            }
+        } else {
+            std::this_thread::yield();
+        }
+        while (link.pollHook(ev, steadyUs())) {
+            char expect[16];
+            snprintf(expect, sizeof(expect), "h%lu", (unsigned long)hooksGot);
+            if (strcmp(expect, ev.name)) hookBad++;
+            hooksGot++;
+        }
+    }
+    mainDone = true;
+    while (hooksGot < HOOKS) {
+        if (link.pollHook(ev, steadyUs())) {
+            char expect[16];
+            snprintf(expect, sizeof(expect), "h%lu", (unsigned long)hooksGot);
+            if (strcmp(expect, ev.name)) hookBad++;
+            hooksGot++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    net.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, badOrder.load());
+    TEST_ASSERT_EQUAL_UINT32(0, hookBad);
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, framesSeen.load());
+    TEST_ASSERT_EQUAL_UINT32(FRAMES / 64, cmdsSeen.load());
+    TEST_ASSERT_EQUAL_UINT32(HOOKS, hooksGot);
+    TEST_ASSERT_LESS_OR_EQUAL(NET_AUDIO_QUEUE_LEN, link.audioQueue().highWater());
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, link.audioLatency().count);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "cross-thread audio latency avg %lu us max %lu us, queue hw %lu",
+             (unsigned long)link.audioLatency().avgUs(), (unsigned long)link.audioLatency().maxUs,
+             (unsigned long)link.audioQueue().highWater());
+    TEST_MESSAGE(msg);
+}
+
+void run_net_link_tests(void) {
+    RUN_TEST(test_netlink_start_audio_end_order);
+    RUN_TEST(test_netlink_button_command_interleaves_with_audio);
+    RUN_TEST(test_netlink_drain_respects_max);
+    RUN_TEST(test_netlink_long_req_id_truncated);
+    RUN_TEST(test_netlink_full_audio_queue_drops_and_keeps_order);
+    RUN_TEST(test_netlink_oversized_frame_rejected);
+    RUN_TEST(test_netlink_latency_metrics);
+    RUN_TEST(test_netlink_threaded_stress);
+}
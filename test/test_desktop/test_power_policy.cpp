@@ -0,0 +1,172 @@
+#include <unity.h>
+#include "PowerPolicy.h"
+
+static const PowerInputs IDLE = {false, 0};
+static const PowerInputs RECORDING = {true, 0};
+
+// Simulated clock: advance in 1s steps, re-evaluating like loop() would
+static PowerMode runUntil(PowerPolicy& p, uint32_t& now, uint32_t until, const PowerInputs& in) {
+    PowerMode m = p.update(now, in);
+    while (now < until) {
+        now += 1000;
+        if (now > until) now = until;
+        m = p.update(now, in);
+    }
+    return m;
+}
+
+// ==================== 模式切换 ====================
+
+void test_power_starts_in_performance(void) {
+    PowerPolicy p;
+    p.begin(0);
+    TEST_ASSERT_EQUAL(POWER_PERFORMANCE, p.update(0, IDLE));
+    TEST_ASSERT_FALSE(p.changed());
+}
+
+void test_power_idle_ladder(void) {
+    PowerPolicy p;
+    uint32_t now = 1000;
+    p.begin(now);
+    TEST_ASSERT_EQUAL(POWER_PERFORMANCE, runUntil(p, now, 1000 + POWER_ACTIVE_HOLD_MS - 1000, IDLE));
+    TEST_ASSERT_EQUAL(POWER_MODEM_SLEEP, runUntil(p, now, 1000 + POWER_ACTIVE_HOLD_MS, IDLE));
+    TEST_ASSERT_TRUE(p.changed());
+    TEST_ASSERT_EQUAL(POWER_MODEM_SLEEP, runUntil(p, now, 1000 + POWER_LIGHT_SLEEP_AFTER_MS - 1000, IDLE));
+    TEST_ASSERT_EQUAL(POWER_LIGHT_SLEEP, runUntil(p, now, 1000 + POWER_LIGHT_SLEEP_AFTER_MS, IDLE));
+    TEST_ASSERT_EQUAL(POWER_LIGHT_SLEEP, runUntil(p, now, 1000 + AUTO_SHUTDOWN_MS - 1000, IDLE));
+    TEST_ASSERT_EQUAL(POWER_DEEP_SLEEP, runUntil(p, now, 1000 + AUTO_SHUTDOWN_MS, IDLE));
+}
+
+void test_power_changed_only_on_transition(void) {
+    PowerPolicy p;
+    uint32_t now = 0;
+    p.begin(now);
+    runUntil(p, now, POWER_ACTIVE_HOLD_MS, IDLE);
+    TEST_ASSERT_TRUE(p.changed());
+    p.update(now + 1, IDLE);
+    TEST_ASSERT_FALSE(p.changed());
+}
+
+void test_power_recording_holds_performance(void) {
+    PowerPolicy p;
+    uint32_t now = 0;
+    p.begin(now);
+    // Recording long past every idle threshold never leaves performance
+    TEST_ASSERT_EQUAL(POWER_PERFORMANCE, runUntil(p, now, AUTO_SHUTDOWN_MS * 2, RECORDING));
+    // ...and idle timing restarts from the last button, not from the stop
+    TEST_ASSERT_EQUAL(POWER_DEEP_SLEEP, p.update(now, IDLE));
+}
+
+void test_power_button_activity_returns_to_performance(void) {
+    PowerPolicy p;
+    uint32_t now = 0;
+    p.begin(now);
+    TEST_ASSERT_EQUAL(POWER_LIGHT_SLEEP, runUntil(p, now, POWER_LIGHT_SLEEP_AFTER_MS + 5000, IDLE));
+    p.noteActivity(now);
+    TEST_ASSERT_EQUAL(POWER_PERFORMANCE, p.update(now, IDLE));
+    TEST_ASSERT_TRUE(p.changed());
+}
+
+void test_power_pending_hooks_block_light_and_deep_sleep(void) {
+    PowerPolicy p;
+    uint32_t now = 0;
+    p.begin(now);
+    PowerInputs hooks = {false, 2};
+    TEST_ASSERT_EQUAL(POWER_MODEM_SLEEP, runUntil(p, now, AUTO_SHUTDOWN_MS + 10000, hooks));
+    TEST_ASSERT_EQUAL(POWER_DEEP_SLEEP, p.update(now, IDLE));
+}
+
+void test_power_hook_keeps_modem_sleep(void) {
+    PowerPolicy p;
+    uint32_t now = 0;
+    p.begin(now);
+    runUntil(p, now, POWER_LIGHT_SLEEP_AFTER_MS - 5000, IDLE);
+    p.noteHook(now);
+    TEST_ASSERT_EQUAL(POWER_MODEM_SLEEP, runUntil(p, now, POWER_LIGHT_SLEEP_AFTER_MS + 5000, IDLE));
+    TEST_ASSERT_EQUAL(POWER_LIGHT_SLEEP, runUntil(p, now, 2 * POWER_LIGHT_SLEEP_AFTER_MS, IDLE));
+}
+
+// ==================== BtnA 预热 ====================
+
+void test_power_btna_prewarms_from_light_sleep(void) {
+    PowerPolicy p;
+    uint32_t now = 0;
+    p.begin(now);
+    runUntil(p, now, POWER_LIGHT_SLEEP_AFTER_MS + 5000, IDLE);
+    p.noteBtnAPress(now);
+    TEST_ASSERT_EQUAL(POWER_PERFORMANCE, p.update(now, IDLE));
+}
+
+void test_power_prewarm_expires_without_recording(void) {
+    PowerPolicy p;
+    uint32_t now = 0;
+    p.begin(now);
+    runUntil(p, now, POWER_LIGHT_SLEEP_AFTER_MS + 5000, IDLE);
+    p.noteBtnAPress(now);
+    uint32_t pressed = now;
+    // Pre-warm and active hold overlap; afterwards back to modem sleep
+    uint32_t hold = POWER_PREWARM_HOLD_MS > POWER_ACTIVE_HOLD_MS ? POWER_PREWARM_HOLD_MS : POWER_ACTIVE_HOLD_MS;
+    TEST_ASSERT_EQUAL(POWER_PERFORMANCE, runUntil(p, now, pressed + hold - 1, IDLE));
+    TEST_ASSERT_EQUAL(POWER_MODEM_SLEEP, runUntil(p, now, pressed + hold, IDLE));
+}
+
+// ==================== 唤醒到首帧延迟 ====================
+
+void test_power_wake_to_first_frame_per_mode(void) {
+    PowerPolicy p;
+    uint32_t now = 0;
+    p.begin(now);
+
+    // Wake from modem sleep: 120ms to first frame
+    runUntil(p, now, POWER_ACTIVE_HOLD_MS + 1000, IDLE);
+    TEST_ASSERT_EQUAL(POWER_MODEM_SLEEP, p.mode());
+    p.noteBtnAPress(now);
+    p.update(now, IDLE);
+    p.noteFirstFrame(now + 120);
+    p.noteFirstFrame(now + 140);   // later frames are ignored
+
+    // Wake from light sleep: 300ms
+    now += 120;
+    runUntil(p, now, now + POWER_LIGHT_SLEEP_AFTER_MS + 1000, IDLE);
+    TEST_ASSERT_EQUAL(POWER_LIGHT_SLEEP, p.mode());
+    p.noteBtnAPress(now);
+    p.noteFirstFrame(now + 300);
+
+    TEST_ASSERT_EQUAL_UINT32(1, p.wakeToFirstFrame(POWER_MODEM_SLEEP).count);
+    TEST_ASSERT_EQUAL_UINT32(120000, p.wakeToFirstFrame(POWER_MODEM_SLEEP).lastUs);
+    TEST_ASSERT_EQUAL_UINT32(1, p.wakeToFirstFrame(POWER_LIGHT_SLEEP).count);
+    TEST_ASSERT_EQUAL_UINT32(300000, p.wakeToFirstFrame(POWER_LIGHT_SLEEP).lastUs);
+    TEST_ASSERT_EQUAL_UINT32(0, p.wakeToFirstFrame(POWER_PERFORMANCE).count);
+}
+
+void test_power_first_frame_without_press_ignored(void) {
+    PowerPolicy p;
+    p.begin(0);
+    p.noteFirstFrame(50);
+    for (int m = 0; m < POWER_MODE_COUNT; m++) {
+        TEST_ASSERT_EQUAL_UINT32(0, p.wakeToFirstFrame((PowerMode)m).count);
+    }
+}
+
+void test_power_millis_wraparound(void) {
+    PowerPolicy p;
+    uint32_t now = 0xFFFFFFFFu - 2000;
+    p.begin(now);
+    now += 4000;   // wrapped
+    TEST_ASSERT_EQUAL(POWER_PERFORMANCE, p.update(now, IDLE));
+}
+
+void run_power_policy_tests(void) {
+    RUN_TEST(test_power_starts_in_performance);
+    RUN_TEST(test_power_idle_ladder);
+    RUN_TEST(test_power_changed_only_on_transition);
+    RUN_TEST(test_power_recording_holds_performance);
+    RUN_TEST(test_power_button_activity_returns_to_performance);
+    RUN_TEST(test_power_pending_hooks_block_light_and_deep_sleep);
+    RUN_TEST(test_power_hook_keeps_modem_sleep);
+    RUN_TEST(test_power_btna_prewarms_from_light_sleep);
+    RUN_TEST(test_power_prewarm_expires_without_recording);
+    RUN_TEST(test_power_wake_to_first_frame_per_mode);
+    RUN_TEST(test_power_first_frame_without_press_ignored);
+    RUN_TEST(test_power_millis_wraparound);
+}
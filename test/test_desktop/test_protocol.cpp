@@ -0,0 +1,106 @@
+#include <unity.h>
+#include <string.h>
+#include "Protocol.h"
+
+// ==================== 消息构造 ====================
+
+void test_protocol_start_message_fields_in_order(void) {
+    char out[JSON_OUT_MAX_LEN];
+    size_t n = protocolStart(out, sizeof(out), "tok", "req-ab12-345");
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"start\",\"token\":\"tok\",\"reqId\":\"req-ab12-345\",\"mode\":\"paste\","
+                             "\"format\":\"pcm_s16le\",\"sampleRate\":16000,\"channels\":1,\"bitDepth\":16}",
+                             out);
+    TEST_ASSERT_EQUAL_size_t(strlen(out), n);
+}
+
+void test_protocol_end_and_command_messages(void) {
+    char out[64];
+    TEST_ASSERT_GREATER_THAN(0, protocolEnd(out, sizeof(out), "req-1"));
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"end\",\"reqId\":\"req-1\"}", out);
+    TEST_ASSERT_GREATER_THAN(0, protocolCommand(out, sizeof(out), "toggle_auto_approve"));
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"command\",\"action\":\"toggle_auto_approve\"}", out);
+}
+
+void test_protocol_strings_are_escaped(void) {
+    char out[96];
+    protocolEnd(out, sizeof(out), "a\"b\\c\nd\x01");
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"end\",\"reqId\":\"a\\\"b\\\\c\\u000ad\\u0001\"}", out);
+    protocolEnd(out, sizeof(out), nullptr);
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"end\",\"reqId\":\"\"}", out);
+}
+
+void test_protocol_overflow_yields_nothing(void) {
+    const char* expect = "{\"type\":\"end\",\"reqId\":\"req-1\"}";
+    char out[64];
+    size_t exact = strlen(expect) + 1;
+    TEST_ASSERT_EQUAL_size_t(exact - 1, protocolEnd(out, exact, "req-1"));
+    memset(out, 'x', sizeof(out));
+    TEST_ASSERT_EQUAL_size_t(0, protocolEnd(out, exact - 1, "req-1"));
+    TEST_ASSERT_TRUE(out[exact - 1] == 'x');   // never writes past cap
+    TEST_ASSERT_EQUAL_size_t(0, protocolEnd(nullptr, 64, "req-1"));
+    TEST_ASSERT_EQUAL_size_t(0, protocolCommand(out, 0, "approve"));
+}
+
+void test_protocol_longest_start_fits_budget(void) {
+    // Worst case: a REQ_ID_MAX_LEN id of characters that need escaping
+    char reqId[REQ_ID_MAX_LEN];
+    memset(reqId, '"', sizeof(reqId) - 1);
+    reqId[sizeof(reqId) - 1] = '\0';
+    char token[65];
+    memset(token, 'k', sizeof(token) - 1);
+    token[sizeof(token) - 1] = '\0';
+    char out[JSON_OUT_MAX_LEN];
+    TEST_ASSERT_GREATER_THAN(0, protocolStart(out, sizeof(out), token, reqId));
+}
+
+void test_protocol_req_id_format(void) {
+    char out[REQ_ID_MAX_LEN];
+    TEST_ASSERT_EQUAL_size_t(20, protocolReqId(out, sizeof(out), 0xdeadbeef, 1234567));
+    TEST_ASSERT_EQUAL_STRING("req-deadbeef-1234567", out);
+    char small[8];
+    TEST_ASSERT_EQUAL_size_t(7, protocolReqId(small, sizeof(small), 0xdeadbeef, 1));
+    TEST_ASSERT_EQUAL_STRING("req-dea", small);
+}
+
+// ==================== 去重 ====================
+
+void test_recent_ids_dedupe_and_evict(void) {
+    RecentIds ids;
+    TEST_ASSERT_FALSE(ids.seen("a"));
+    TEST_ASSERT_TRUE(ids.seen("a"));
+    TEST_ASSERT_FALSE(ids.seen(""));
+    TEST_ASSERT_FALSE(ids.seen(""));
+    TEST_ASSERT_FALSE(ids.seen(nullptr));
+
+    char id[8];
+    for (int i = 0; i < HOOK_ID_DEDUP - 1; i++) {
+        snprintf(id, sizeof(id), "id%d", i);
+        TEST_ASSERT_FALSE(ids.seen(id));
+    }
+    TEST_ASSERT_TRUE(ids.seen("a"));     // still within the last HOOK_ID_DEDUP
+    TEST_ASSERT_FALSE(ids.seen("new"));  // evicts "a"
+    TEST_ASSERT_FALSE(ids.seen("a"));
+
+    ids.clear();
+    TEST_ASSERT_FALSE(ids.seen("new"));
+}
+
+void test_recent_ids_uuid_fits(void) {
+    RecentIds ids;
+    const char* a = "4f1c2b9e-8d7a-4c3b-9e2f-1a2b3c4d5e6f";
+    const char* b = "4f1c2b9e-8d7a-4c3b-9e2f-1a2b3c4d5e70";
+    TEST_ASSERT_FALSE(ids.seen(a));
+    TEST_ASSERT_FALSE(ids.seen(b));
+    TEST_ASSERT_TRUE(ids.seen(a));
+}
+
+void run_protocol_tests(void) {
+    RUN_TEST(test_protocol_start_message_fields_in_order);
+    RUN_TEST(test_protocol_end_and_command_messages);
+    RUN_TEST(test_protocol_strings_are_escaped);
+    RUN_TEST(test_protocol_overflow_yields_nothing);
+    RUN_TEST(test_protocol_longest_start_fits_budget);
+    RUN_TEST(test_protocol_req_id_format);
+    RUN_TEST(test_recent_ids_dedupe_and_evict);
+    RUN_TEST(test_recent_ids_uuid_fits);
+}
@@ -0,0 +1,272 @@
+#include <unity.h>
+#include "RoamPolicy.h"
+
+static const uint8_t AP_A[6] = {0xa0, 0, 0, 0, 0, 1};
+static const uint8_t AP_B[6] = {0xb0, 0, 0, 0, 0, 2};
+static const uint8_t AP_C[6] = {0xc0, 0, 0, 0, 0, 3};
+
+static RoamCandidate cand(const uint8_t* bssid, int8_t rssi, uint8_t net = 0) {
+    RoamCandidate c;
+    memcpy(c.bssid, bssid, 6);
+    c.netIndex = net;
+    c.rssi = rssi;
+    c.channel = 6;
+    return c;
+}
+
+// Scripted RSSI trace: one sample per ROAM_SAMPLE_MS, like serviceRoaming().
+// Returns how many scans were requested; *firstScanMs gets the first one.
+struct Step {
+    uint32_t untilMs;   // hold this RSSI / busy state until here
+    int8_t rssi;
+    bool busy;
+};
+
+static uint32_t replay(RoamPolicy& p, uint32_t& now, const Step* steps, size_t n, uint32_t* firstScanMs = nullptr) {
+    uint32_t scans = 0;
+    for (size_t i = 0; i < n; i++) {
+        while (now < steps[i].untilMs) {
+            now += ROAM_SAMPLE_MS;
+            p.noteRssi(steps[i].rssi);
+            if (p.shouldScan(now, steps[i].busy)) {
+                if (!scans && firstScanMs) *firstScanMs = now;
+                scans++;
+            }
+        }
+    }
+    return scans;
+}
+
+static void start(RoamPolicy& p, uint32_t now, const uint8_t* bssid = AP_A) {
+    p.begin(now);
+    p.noteConnected(now, bssid);
+}
+
+// ==================== 触发扫描 ====================
+
+void test_roam_strong_link_never_scans(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    Step trace[] = {{600000, -55, false}};
+    TEST_ASSERT_EQUAL_UINT32(0, replay(p, now, trace, 1));
+}
+
+void test_roam_single_dips_are_smoothed_out(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    // -60 with isolated -85 spikes every 10s
+    uint32_t scans = 0;
+    for (int i = 0; i < 300; i++) {
+        now += ROAM_SAMPLE_MS;
+        p.noteRssi(i % 10 == 9 ? -85 : -60);
+        if (p.shouldScan(now, false)) scans++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, scans);
+    TEST_ASSERT_TRUE(p.rssiEma() > ROAM_RSSI_TRIGGER_DBM);
+}
+
+void test_roam_sustained_weak_link_scans_once_per_interval(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    uint32_t first = 0;
+    start(p, now);
+    Step trace[] = {{10000, -60, false}, {10000 + ROAM_SCAN_INTERVAL_MS * 3, -78, false}};
+    uint32_t scans = replay(p, now, trace, 2, &first);
+    TEST_ASSERT_TRUE(first > 10000 && first <= 10000 + 5 * ROAM_SAMPLE_MS);
+    // One scan at the start plus one per full interval after it
+    TEST_ASSERT_EQUAL_UINT32(3, scans);
+    TEST_ASSERT_EQUAL_UINT32(3, p.stats().scans);
+}
+
+void test_roam_needs_minimum_samples_after_connect(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    Step trace[] = {{(ROAM_MIN_SAMPLES - 1) * ROAM_SAMPLE_MS, -85, false}};
+    TEST_ASSERT_EQUAL_UINT32(0, replay(p, now, trace, 1));
+    Step more[] = {{now + ROAM_SAMPLE_MS, -85, false}};
+    TEST_ASSERT_EQUAL_UINT32(1, replay(p, now, more, 1));
+}
+
+void test_roam_tx_failures_trigger_scan_on_good_rssi(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    Step warm[] = {{10000, -58, false}};
+    replay(p, now, warm, 1);
+    TEST_ASSERT_FALSE(p.shouldScan(now, false));
+    // 1 in 4 sends failing
+    for (int i = 0; i < 100; i++) p.noteTx(i % 4 != 0);
+    TEST_ASSERT_TRUE(p.weak());
+    TEST_ASSERT_TRUE(p.shouldScan(now + 1000, false));
+}
+
+// ==================== 录音期间不漫游 ====================
+
+void test_roam_never_scans_while_busy(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    Step trace[] = {{60000, -82, true}};
+    TEST_ASSERT_EQUAL_UINT32(0, replay(p, now, trace, 1));
+}
+
+void test_roam_waits_idle_period_after_utterance(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    uint32_t first = 0;
+    start(p, now);
+    Step trace[] = {{20000, -82, true}, {40000, -82, false}};
+    TEST_ASSERT_EQUAL_UINT32(1, replay(p, now, trace, 2, &first));
+    TEST_ASSERT_TRUE(first >= 20000 + ROAM_IDLE_AFTER_MS);
+    TEST_ASSERT_TRUE(first <= 20000 + ROAM_IDLE_AFTER_MS + ROAM_SAMPLE_MS);
+}
+
+void test_roam_results_dropped_if_utterance_started(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    Step trace[] = {{10000, -80, false}};
+    TEST_ASSERT_EQUAL_UINT32(1, replay(p, now, trace, 1));
+    RoamCandidate c[] = {cand(AP_B, -50)};
+    TEST_ASSERT_EQUAL(-1, p.pickTarget(now + 500, true, c, 1));
+}
+
+// ==================== 选择目标 ====================
+
+void test_roam_picks_strongest_clearly_better_bssid(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    uint32_t first = 0;
+    Step trace[] = {{10000, -78, false}};
+    TEST_ASSERT_EQUAL_UINT32(1, replay(p, now, trace, 1, &first));
+    RoamCandidate c[] = {
+        cand(AP_A, -45),             // current AP (scan sees it stronger): never a target
+        cand(AP_B, -62, 1),
+        cand(AP_C, -55, 0),
+    };
+    TEST_ASSERT_EQUAL(2, p.pickTarget(first + 1500, false, c, 3));
+}
+
+void test_roam_ignores_marginal_improvement(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    uint32_t first = 0;
+    Step trace[] = {{10000, -75, false}};
+    replay(p, now, trace, 1, &first);
+    RoamCandidate c[] = {cand(AP_B, (int8_t)(-75 + ROAM_HYSTERESIS_DB - 1))};
+    TEST_ASSERT_EQUAL(-1, p.pickTarget(first + 1000, false, c, 1));
+    c[0].rssi = (int8_t)(-75 + ROAM_HYSTERESIS_DB);
+    TEST_ASSERT_EQUAL(0, p.pickTarget(first + 1000, false, c, 1));
+}
+
+void test_roam_stale_scan_results_ignored(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    Step trace[] = {{10000, -80, false}};
+    replay(p, now, trace, 1);
+    RoamCandidate c[] = {cand(AP_B, -50)};
+    TEST_ASSERT_EQUAL(-1, p.pickTarget(now + ROAM_SCAN_MAX_AGE_MS + 1, false, c, 1));
+}
+
+void test_roam_no_target_without_scan(void) {
+    RoamPolicy p;
+    start(p, 0);
+    RoamCandidate c[] = {cand(AP_B, -40)};
+    TEST_ASSERT_EQUAL(-1, p.pickTarget(1000, false, c, 1));
+}
+
+// ==================== 冷却与指标 ====================
+
+void test_roam_cooldown_prevents_ping_pong(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    Step trace[] = {{10000, -80, false}};
+    replay(p, now, trace, 1);
+    RoamCandidate target = cand(AP_B, -60);
+    p.noteRoam(now, target, true);
+    TEST_ASSERT_TRUE(p.isCurrent(AP_B));
+    uint32_t roamMs = now;
+
+    // New AP fades too: no scan until the cooldown is over
+    uint32_t first = 0;
+    Step fade[] = {{roamMs + ROAM_COOLDOWN_MS * 2, -80, false}};
+    TEST_ASSERT_TRUE(replay(p, now, fade, 1, &first) >= 1);
+    TEST_ASSERT_TRUE(first >= roamMs + ROAM_COOLDOWN_MS);
+}
+
+void test_roam_failed_roam_counts_and_cools_down(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    Step trace[] = {{10000, -80, false}};
+    replay(p, now, trace, 1);
+    p.noteRoam(now, cand(AP_B, -55), false);
+    TEST_ASSERT_EQUAL_UINT32(0, p.stats().roams);
+    TEST_ASSERT_EQUAL_UINT32(1, p.stats().failedRoams);
+    TEST_ASSERT_TRUE(p.isCurrent(AP_A));
+    TEST_ASSERT_FALSE(p.shouldScan(now + ROAM_SCAN_INTERVAL_MS + 1000, false));
+}
+
+void test_roam_records_pre_post_throughput(void) {
+    RoamPolicy p;
+    uint32_t now = 0;
+    start(p, now);
+    p.noteUpload(64000, 4000000);   // 64 KB over a 4 s utterance = 128 kbps
+    Step trace[] = {{10000, -81, false}};
+    replay(p, now, trace, 1);
+    p.noteRoam(now, cand(AP_B, -52), true);
+    const RoamStats& s = p.stats();
+    TEST_ASSERT_EQUAL_UINT32(1, s.roams);
+    TEST_ASSERT_EQUAL_INT(-52, s.lastToRssi);
+    TEST_ASSERT_TRUE(s.lastFromRssi <= -78);
+    TEST_ASSERT_EQUAL_UINT32(128, s.lastPreKbps);
+    TEST_ASSERT_EQUAL_UINT32(0, s.lastPostKbps);
+    p.noteUpload(64000, 500000);    // 1024 kbps
+    p.noteUpload(64000, 1000000);   // later utterances do not overwrite
+    TEST_ASSERT_EQUAL_UINT32(1024, p.stats().lastPostKbps);
+}
+
+void test_roam_office_trace_end_to_end(void) {
+    // Walk away from AP_A while idle, record once on the way, then sit far away
+    RoamPolicy p;
+    uint32_t now = 0;
+    uint32_t first = 0;
+    start(p, now);
+    Step trace[] = {
+        {30000, -55, false},
+        {60000, -66, false},
+        {70000, -79, true},    // utterance on a fading link: no scan
+        {71000, -79, false},   // inside the idle window
+        {90000, -80, false},
+    };
+    TEST_ASSERT_EQUAL_UINT32(1, replay(p, now, trace, 5, &first));
+    TEST_ASSERT_TRUE(first >= 70000 + ROAM_IDLE_AFTER_MS);
+    RoamCandidate c[] = {cand(AP_A, -80), cand(AP_B, -58, 1)};
+    TEST_ASSERT_EQUAL(1, p.pickTarget(first + 1500, false, c, 2));
+}
+
+void run_roam_policy_tests(void) {
+    RUN_TEST(test_roam_strong_link_never_scans);
+    RUN_TEST(test_roam_single_dips_are_smoothed_out);
+    RUN_TEST(test_roam_sustained_weak_link_scans_once_per_interval);
+    RUN_TEST(test_roam_needs_minimum_samples_after_connect);
+    RUN_TEST(test_roam_tx_failures_trigger_scan_on_good_rssi);
+    RUN_TEST(test_roam_never_scans_while_busy);
+    RUN_TEST(test_roam_waits_idle_period_after_utterance);
+    RUN_TEST(test_roam_results_dropped_if_utterance_started);
+    RUN_TEST(test_roam_picks_strongest_clearly_better_bssid);
+    RUN_TEST(test_roam_ignores_marginal_improvement);
+    RUN_TEST(test_roam_stale_scan_results_ignored);
+    RUN_TEST(test_roam_no_target_without_scan);
+    RUN_TEST(test_roam_cooldown_prevents_ping_pong);
+    RUN_TEST(test_roam_failed_roam_counts_and_cools_down);
+    RUN_TEST(test_roam_records_pre_post_throughput);
+    RUN_TEST(test_roam_office_trace_end_to_end);
+}
@@ -0,0 +1,117 @@
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "UploadFramer.h"
+
+static uint32_t fakeUs = 0;
+static uint32_t fakeNow() { return fakeUs; }
+
+// Network side stand-in: keeps everything that comes off the link
+struct CaptureSink {
+    std::vector<NetCommand> commands;
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<bool> order;   // true = audio
+
+    void onCommand(const NetCommand& c) {
+        commands.push_back(c);
+        order.push_back(false);
+    }
+    void onAudio(const AudioFrame& f) {
+        frames.emplace_back(f.data, f.data + f.len);
+        order.push_back(true);
+    }
+};
+
+static void fillChunk(int16_t* pcm, int k) {
+    for (int i = 0; i < CHUNK_SAMPLES; i++) pcm[i] = (int16_t)((k * CHUNK_SAMPLES + i) * 37 % 20000 - 10000);
+}
+
+// ==================== PCM ====================
+
+void test_upload_pcm_start_chunks_end(void) {
+    NetLink link;
+    CaptureSink sink;
+    UploadFramer up(link, nullptr, fakeNow);
+    int16_t pcm[CHUNK_SAMPLES];
+
+    up.start("req-7");
+    for (int k = 0; k < 3; k++) {
+        fillChunk(pcm, k);
+        up.chunk(pcm);
+        link.drain(sink, fakeNow, 100);
+        TEST_ASSERT_EQUAL(CHUNK_BYTES, sink.frames.back().size());
+        TEST_ASSERT_EQUAL_MEMORY(pcm, sink.frames.back().data(), CHUNK_BYTES);
+    }
+    up.finish();
+    link.drain(sink, fakeNow, 100);
+
+    TEST_ASSERT_FALSE(up.logMel());
+    TEST_ASSERT_EQUAL(2, sink.commands.size());
+    TEST_ASSERT_EQUAL(NET_CMD_START, sink.commands[0].type);
+    TEST_ASSERT_EQUAL(NET_CMD_END, sink.commands[1].type);
+    TEST_ASSERT_EQUAL_STRING("req-7", sink.commands[0].reqId);
+    TEST_ASSERT_EQUAL_STRING("req-7", sink.commands[1].reqId);
+    TEST_ASSERT_FALSE(sink.order.front());
+    TEST_ASSERT_FALSE(sink.order.back());
+    TEST_ASSERT_EQUAL_UINT32(0, up.dropped());
+}
+
+// ==================== log-mel ====================
+
+// Same frames, byte for byte, as driving the extractor directly
+void test_upload_logmel_matches_extractor(void) {
+    static LogMelExtractor mel, ref;
+    static float refOut[MEL_FRAMES_PER_CHUNK_MAX * MEL_BINS];
+    static int16_t refQ[MEL_FRAMES_PER_CHUNK_MAX * MEL_BINS];
+    NetLink link;
+    CaptureSink sink;
+    UploadFramer up(link, &mel, fakeNow);
+    int16_t pcm[CHUNK_SAMPLES];
+    std::vector<uint8_t> expected, got;
+    const int CHUNKS = 10;
+
+    up.start("req-mel");
+    ref.reset();
+    for (int k = 0; k < CHUNKS; k++) {
+        fillChunk(pcm, k);
+        up.chunk(pcm);
+        link.drain(sink, fakeNow, 100);
+        size_t n = ref.push(pcm, CHUNK_SAMPLES, refOut);
+        LogMelExtractor::quantize(refOut, refQ, n * MEL_BINS);
+        expected.insert(expected.end(), (uint8_t*)refQ, (uint8_t*)(refQ + n * MEL_BINS));
+    }
+    up.finish();
+    link.drain(sink, fakeNow, 100);
+    size_t n = ref.flush(refOut);
+    LogMelExtractor::quantize(refOut, refQ, n * MEL_BINS);
+    expected.insert(expected.end(), (uint8_t*)refQ, (uint8_t*)(refQ + n * MEL_BINS));
+
+    for (const auto& f : sink.frames) {
+        TEST_ASSERT_EQUAL(0, f.size() % (MEL_BINS * sizeof(int16_t)));
+        got.insert(got.end(), f.begin(), f.end());
+    }
+    TEST_ASSERT_TRUE(up.logMel());
+    TEST_ASSERT_EQUAL((size_t)CHUNKS * CHUNK_SAMPLES / MEL_HOP * MEL_BINS * sizeof(int16_t), got.size());
+    TEST_ASSERT_TRUE(expected == got);
+    TEST_ASSERT_EQUAL(NET_CMD_END, sink.commands.back().type);
+    TEST_ASSERT_FALSE(sink.order.back());   // end after the trailing frames
+}
+
+// ==================== 背压 ====================
+
+void test_upload_counts_rejected_frames(void) {
+    NetLink link;
+    UploadFramer up(link, nullptr, fakeNow);
+    int16_t pcm[CHUNK_SAMPLES] = {};
+
+    up.start("r");
+    for (uint32_t i = 0; i < NET_AUDIO_QUEUE_LEN + 3; i++) up.chunk(pcm);
+    TEST_ASSERT_EQUAL_UINT32(3, up.dropped());
+    TEST_ASSERT_EQUAL_UINT32(3, link.audioQueue().dropped());
+}
+
+void run_upload_framer_tests(void) {
+    RUN_TEST(test_upload_pcm_start_chunks_end);
+    RUN_TEST(test_upload_logmel_matches_extractor);
+    RUN_TEST(test_upload_counts_rejected_frames);
+}